@@ -0,0 +1,44 @@
+/**
+ * @file	SDL_keycode.h
+ *
+ * @brief	Subset of the SDL2 key codes (same names and values) used by \ref ei_types.h, for the
+ *		headless build on machines without the SDL2 headers (CMake option IG_HEADLESS).
+ *		When the SDL2 headers are installed, they are used instead.
+ */
+
+#ifndef HEADLESS_SDL_KEYCODE_H
+#define HEADLESS_SDL_KEYCODE_H
+
+/* like the real header, through SDL_stdinc.h: the sources rely on these declarations */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <string.h>
+#include <stdint.h>
+#include <ctype.h>
+#include <math.h>
+
+#define SDLK_SCANCODE_MASK (1 << 30)
+
+typedef int32_t SDL_Keycode;
+
+typedef enum {
+	SDLK_UNKNOWN	= 0,
+	SDLK_BACKSPACE	= '\b',
+	SDLK_TAB	= '\t',
+	SDLK_RETURN	= '\r',
+	SDLK_ESCAPE	= '\x1B',
+	SDLK_SPACE	= ' ',
+	SDLK_0		= '0', SDLK_1, SDLK_2, SDLK_3, SDLK_4, SDLK_5, SDLK_6, SDLK_7, SDLK_8, SDLK_9,
+	SDLK_a		= 'a', SDLK_b, SDLK_c, SDLK_d, SDLK_e, SDLK_f, SDLK_g, SDLK_h, SDLK_i, SDLK_j,
+	SDLK_k, SDLK_l, SDLK_m, SDLK_n, SDLK_o, SDLK_p, SDLK_q, SDLK_r, SDLK_s, SDLK_t,
+	SDLK_u, SDLK_v, SDLK_w, SDLK_x, SDLK_y, SDLK_z,
+	SDLK_DELETE	= '\x7F',
+	SDLK_RIGHT	= 79 | SDLK_SCANCODE_MASK,
+	SDLK_LEFT	= 80 | SDLK_SCANCODE_MASK,
+	SDLK_DOWN	= 81 | SDLK_SCANCODE_MASK,
+	SDLK_UP		= 82 | SDLK_SCANCODE_MASK
+} SDL_KeyCode;
+
+#endif
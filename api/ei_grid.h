@@ -0,0 +1,97 @@
+/**
+ *  @file	ei_grid.h
+ *  @brief	Manages the positioning and sizing of widgets in rows and columns (tile boards, forms).
+ *
+ */
+
+#ifndef EI_GRID_H
+#define EI_GRID_H
+
+#include "ei_types.h"
+#include "ei_widget.h"
+
+
+
+/**
+ * \brief	Configures the geometry of a widget using the "grid" geometry manager.
+ *
+ *		The grid divides the parent's *content_rect* into rows and columns (the tracks). The
+ *		size of a track is the largest size needed by the widgets in it (their requested size
+ *		plus their padding), at least the minimum size of the track. When the parent is larger
+ *		than the sum of the tracks, the remaining space is shared by the tracks that have a
+ *		weight, in proportion to their weight (see \ref ei_grid_rowconfigure).
+ *
+ * 		If the widget was already managed by the "grid", then this calls simply updates
+ *		the grid parameters: arguments that are not NULL replace previous values.
+ *		Arguments that are NULL don't change the current value of the parameter.
+ *		Calling this function again after changing the requested size of the widget updates
+ *		the size of its row and column.
+ *
+ * @param	widget		The widget to place.
+ * @param	row		The row of the top-left cell of the widget (defaults to 0).
+ * @param	column		The column of the top-left cell of the widget (defaults to 0).
+ * @param	row_span	The number of rows covered by the widget (defaults to 1).
+ * @param	column_span	The number of columns covered by the widget (defaults to 1).
+ * @param	padx		The space left empty on the left and right of the widget, in its cell
+ *				(defaults to 0).
+ * @param	pady		The space left empty above and under the widget, in its cell
+ *				(defaults to 0).
+ * @param	anchor		Where to put the widget in its cell, at its requested size. With
+ *				ei_anc_none, the widget fills its cell (defaults to ei_anc_none).
+ */
+void		ei_grid		(ei_widget_t		widget,
+				 int*			row,
+				 int*			column,
+				 int*			row_span,
+				 int*			column_span,
+				 int*			padx,
+				 int*			pady,
+				 ei_anchor_t*		anchor);
+
+/**
+ * \brief	Configures a row of the grid of a container.
+ *
+ * @param	container	The parent of the widgets managed by the grid.
+ * @param	row		The row to configure.
+ * @param	min_size	The minimum height of the row, also its height when it is empty
+ *				(defaults to 0).
+ * @param	weight		The share of the remaining height given to this row (defaults to 0).
+ */
+void		ei_grid_rowconfigure	(ei_widget_t	container,
+					 int		row,
+					 int*		min_size,
+					 float*		weight);
+
+/**
+ * \brief	Configures a column of the grid of a container.
+ *
+ * @param	container	The parent of the widgets managed by the grid.
+ * @param	column		The column to configure.
+ * @param	min_size	The minimum width of the column, also its width when it is empty
+ *				(defaults to 0).
+ * @param	weight		The share of the remaining width given to this column (defaults to 0).
+ */
+void		ei_grid_columnconfigure	(ei_widget_t	container,
+					 int		column,
+					 int*		min_size,
+					 float*		weight);
+
+/**
+ * \brief	Makes all the rows and/or all the columns of the grid of a container the same size
+ *		(the size of the largest one), as on a tile board.
+ *
+ * @param	container	The parent of the widgets managed by the grid.
+ * @param	rows		If not NULL, whether all the rows have the same height (defaults to false).
+ * @param	columns		If not NULL, whether all the columns have the same width (defaults to false).
+ */
+void		ei_grid_uniform		(ei_widget_t	container,
+					 bool*		rows,
+					 bool*		columns);
+
+
+
+
+
+static inline void ei_grid_cell		(ei_widget_t widget, int row, int column)		{ ei_grid(widget, &row, &column, NULL, NULL, NULL, NULL, NULL); }
+
+#endif
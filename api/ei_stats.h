@@ -0,0 +1,103 @@
+/**
+ *  @file	ei_stats.h
+ *  @brief	Built-in profiler: time spent in each phase of the main loop, and drawing counters.
+ *
+ *		The phases are timed only while the profiler is enabled (see \ref ei_stats_enable).
+ *		If the environment variable EI_STATS is set (and is not "0") when \ref ei_app_create
+ *		is called, the profiler is enabled and its report is printed on the standard error
+ *		output by \ref ei_app_free.
+ */
+
+#ifndef EI_STATS_H
+#define EI_STATS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "ei_types.h"
+
+
+
+/**
+ * \brief	The phases of the main loop (\ref ei_app_run).
+ */
+typedef enum {
+	ei_stats_wait		= 0,	///< Waiting for the next event.
+	ei_stats_dispatch,		///< Dispatching an event, callbacks included.
+	ei_stats_callback,		///< One call of a bind or timer callback.
+	ei_stats_animation,		///< Advancing the animations of a frame.
+	ei_stats_layout,		///< The layout pass of a frame.
+	ei_stats_draw,			///< Drawing the damaged area of a frame.
+	ei_stats_present,		///< Presenting the damaged rectangles on screen.
+	ei_stats_frame,			///< A whole frame (animation, layout, draw and present).
+
+	ei_stats_nb_phases
+} ei_stats_phase_t;
+
+/**
+ * \brief	The counters, accumulated since the creation of the application (or the last
+ *		\ref ei_stats_reset). They are counted even when the profiler is disabled.
+ */
+typedef enum {
+	ei_stats_events		= 0,	///< Events returned by \ref hw_event_wait_next.
+	ei_stats_frames,		///< Frames produced.
+	ei_stats_widgets_drawn,		///< Calls to the drawfunc of a widget class.
+	ei_stats_polygons,		///< Polygons rasterized (at least partly inside their clipper).
+	ei_stats_pixels_blended,	///< Pixels alpha-blended by fills, polygons and surface copies.
+	ei_stats_rects_presented,	///< Rectangles given to \ref hw_surface_update_rects.
+
+	ei_stats_nb_counters
+} ei_stats_counter_t;
+
+/**
+ * \brief	The timings of a phase, in seconds. The percentiles are computed on the most recent
+ *		samples only (a rolling window), the other fields on all the samples.
+ */
+typedef struct {
+	uint64_t		count;		///< Number of samples.
+	double			total;		///< Sum of the samples.
+	double			max;		///< Largest sample.
+	double			p50;		///< Median of the recent samples.
+	double			p95;		///< 95th percentile of the recent samples.
+	double			p99;		///< 99th percentile of the recent samples.
+} ei_stats_summary_t;
+
+/**
+ * \brief	Enables or disables the timing of the phases.
+ *
+ * @param	enabled		true to time the phases.
+ */
+void		ei_stats_enable		(bool			enabled);
+
+/**
+ * \brief	Returns the timings of a phase.
+ *
+ * @param	phase		The phase.
+ * @param	summary		Where to store the timings.
+ *
+ * @return			false if the phase has no sample yet (summary is then zeroed).
+ */
+bool		ei_stats_phase		(ei_stats_phase_t	phase,
+					 ei_stats_summary_t*	summary);
+
+/**
+ * \brief	Returns the value of a counter.
+ *
+ * @param	counter		The counter.
+ *
+ * @return			Its value.
+ */
+uint64_t	ei_stats_counter	(ei_stats_counter_t	counter);
+
+/**
+ * \brief	Forgets all the samples and sets all the counters to 0.
+ */
+void		ei_stats_reset		(void);
+
+/**
+ * \brief	Prints a report of all the phases and counters.
+ *
+ * @param	file		Where to print the report (for example stderr).
+ */
+void		ei_stats_dump		(FILE*			file);
+
+#endif
@@ -0,0 +1,87 @@
+/**
+ * @file	hw_headless.h
+ *
+ * @brief	Controls of the in-memory implementation of \ref hw_interface.h (CMake option
+ *		IG_HEADLESS). Nothing is displayed: surfaces are plain memory, events come from a
+ *		script, and time is virtual, so that a whole application runs deterministically
+ *		and as fast as possible, without a display server.
+ *
+ *		- Surfaces use the channel order of the root surface (blue, green, red, alpha in
+ *		  memory). The root surface has no alpha channel.
+ *		- \ref hw_now returns a virtual time, in seconds, that starts at 0 and only moves
+ *		  when \ref hw_event_wait_next returns an event later than the current time.
+ *		- \ref hw_event_wait_next returns the earliest of the scripted events and of the
+ *		  application events (\ref hw_event_post_app, \ref hw_event_schedule_app), without
+ *		  waiting. When there is none, it calls the idle function (see
+ *		  \ref hw_headless_set_idle), then returns \ref ei_ev_close if there is still none.
+ *		- \ref hw_surface_update_rects only records the damage (see \ref hw_headless_get_damage).
+ *		- Text is rendered with one box per character (size/2 x size pixels), and
+ *		  \ref hw_image_load returns a 256x256 gradient, whatever the file.
+ */
+
+#ifndef HW_HEADLESS_H
+#define HW_HEADLESS_H
+
+#include <stdint.h>
+
+#include "hw_interface.h"
+
+struct ei_event_t;
+
+/**
+ * @brief	What \ref hw_surface_update_rects received since \ref hw_init (or the last
+ *		\ref hw_headless_reset_damage).
+ */
+typedef struct {
+	int			updates;	///< Number of calls.
+	int			rects;		///< Number of rectangles.
+	int64_t			area;		///< Sum of the areas of the rectangles, in pixels.
+	ei_rect_t		bounds;		///< Bounding box of all the rectangles.
+} hw_headless_damage_t;
+
+/**
+ * @brief	Appends an event to the script.
+ *
+ * @param	event		The event (a copy is made).
+ * @param	ms_delay	Virtual time, in milliseconds, between the previous scripted event
+ *				(or the current time, if the script is exhausted) and this one.
+ */
+void hw_headless_push_event(const struct ei_event_t* event, int ms_delay);
+
+/**
+ * @brief	Sets the function called by \ref hw_event_wait_next when there is no event left.
+ *		It may push events, or ask the application to quit (\ref ei_app_quit_request).
+ *
+ * @param	idle		The function, or NULL.
+ */
+void hw_headless_set_idle(void (*idle)(void));
+
+/**
+ * @brief	Moves the virtual time forward.
+ *
+ * @param	seconds		The amount of time (ignored if not positive).
+ */
+void hw_headless_advance(double seconds);
+
+/**
+ * @brief	Returns the damage recorded by \ref hw_surface_update_rects.
+ *
+ * @param	damage		Where to store it.
+ */
+void hw_headless_get_damage(hw_headless_damage_t* damage);
+
+/**
+ * @brief	Forgets the recorded damage.
+ */
+void hw_headless_reset_damage(void);
+
+/**
+ * @brief	Returns a hash of the pixels of a surface (FNV-1a), to compare renderings.
+ *
+ * @param	surface		The surface.
+ *
+ * @return			The hash.
+ */
+uint32_t hw_headless_checksum(ei_surface_t surface);
+
+#endif
@@ -0,0 +1,107 @@
+/**
+ *  @file	ei_animation.c
+ *  @brief	Animates the geometry and the color of widgets over time (sliding tiles, fading frames,
+ *		moving toplevels).
+ *
+ */
+
+#include "ei_animation.h"
+#include "ei_impl_animation.h"
+#include "ei_geometrymanager.h"
+#include "ei_placer.h"
+#include "ei_impl_atom.h"
+
+
+/**
+ * \brief	Animates the placement of a widget managed by the "placer": its x, y, width and height
+ *		parameters (see \ref ei_place) go from their current value to the given values.
+ *
+ *		The animations advance once per frame, just before the geometry is computed and the
+ *		screen is drawn: all the widgets animated in a frame are placed together, and only the
+ *		old and new bounds of each moved widget are redrawn.
+ *
+ *		Starting an animation of the placement of a widget replaces the one that was running.
+ *		If the widget is not managed by the placer, it is placed at the end values right away.
+ *
+ * @param	widget		The widget to animate.
+ * @param	x, y		If not NULL, the final position (placer parameters x and y).
+ * @param	width, height	If not NULL, the final size (placer parameters width and height).
+ * @param	ms_duration	The duration of the animation, in milliseconds.
+ * @param	easing		How the progress is distributed over the duration.
+ * @param	done		If not NULL, called after the final values are set.
+ * @param	user_param	A programmer supplied parameter that will be passed to done.
+ *
+ * @return			The animation, to give to \ref ei_animation_cancel while it runs,
+ *				or NULL if there is nothing to animate.
+ */
+ei_animation_t	ei_animate_place	(ei_widget_t		widget,
+					 int*			x,
+					 int*			y,
+					 int*			width,
+					 int*			height,
+					 int			ms_duration,
+					 ei_easing_t		easing,
+					 ei_animation_callback_t done,
+					 ei_user_param_t	user_param){
+        if (!widget || !(x || y || width || height)) return NULL;
+        if (!widget->geom_params || widget->geom_params->manager != ei_geometrymanager_from_name("placer\0")){
+                ei_place(widget, NULL, x, y, width, height, NULL, NULL, NULL, NULL);
+                return NULL;
+        }
+        ei_impl_animation_t model = {0};
+        int* to[4] = {x, y, width, height};
+        for (int k = 0; k < 4; k++){
+                model.animated[k] = to[k] != NULL;
+                model.to[k] = to[k] ? *to[k] : 0;
+        }
+        model.widget = widget;
+        model.property = ei_impl_animation_place;
+        model.duration = ms_duration / 1000.0;
+        model.easing = easing;
+        model.done = done;
+        model.user_param = user_param;
+        return ei_impl_animation_start(&model);
+}
+
+/**
+ * \brief	Animates the background color of a frame, a button or a toplevel, from its current
+ *		color to the given one (alpha included: fades a frame in or out).
+ *
+ *		Starting an animation of the color of a widget replaces the one that was running.
+ *
+ * @param	widget		The widget to animate.
+ * @param	color		The final color.
+ * @param	ms_duration, easing, done, user_param
+ *				See \ref ei_animate_place.
+ *
+ * @return			The animation, or NULL if the widget has no color to animate.
+ */
+ei_animation_t	ei_animate_color	(ei_widget_t		widget,
+					 ei_color_t		color,
+					 int			ms_duration,
+					 ei_easing_t		easing,
+					 ei_animation_callback_t done,
+					 ei_user_param_t	user_param){
+        if (!widget || !(ei_impl_widget_is(widget, ei_atom_frame) || ei_impl_widget_is(widget, ei_atom_button)
+                         || ei_impl_widget_is(widget, ei_atom_toplevel))) return NULL;
+        ei_impl_animation_t model = {0};
+        model.widget = widget;
+        model.property = ei_impl_animation_color;
+        model.to_color = color;
+        model.duration = ms_duration / 1000.0;
+        model.easing = easing;
+        model.done = done;
+        model.user_param = user_param;
+        return ei_impl_animation_start(&model);
+}
+
+/**
+ * \brief	Stops an animation where it is: the widget keeps its current values, and the done
+ *		function is not called. Must not be called after the animation has ended. The
+ *		animations of a widget are cancelled when it is destroyed.
+ *
+ * @param	animation	The animation to cancel.
+ */
+void		ei_animation_cancel	(ei_animation_t		animation){
+        ei_impl_animation_remove(animation);
+}
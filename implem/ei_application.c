@@ -17,6 +17,18 @@
 #include "ei_event.h"
 #include "ei_impl_binds.h"
 #include "ei_impl_placer.h"
+#include "ei_impl_grid.h"
+#include "ei_impl_font.h"
+#include "ei_impl_region.h"
+#include "ei_impl_pick.h"
+#include "ei_impl_atom.h"
+#include "ei_impl_slab.h"
+#include "ei_impl_layout.h"
+#include "ei_impl_frame.h"
+#include "ei_impl_timer.h"
+#include "ei_impl_animation.h"
+#include "ei_impl_stats.h"
+#include "ei_impl_record.h"
 #include "var.h"
 
 //variable globale designant la surface offscreen de picking
@@ -27,8 +39,8 @@ ei_impl_widget_t* root = NULL;
 bool quit              = false;
 //variable globale designant la surface root
 ei_surface_t root_surface;
-//variable globale designant la liste chainée des rectangles a update sur la root_surface
-ei_linked_rect_t* rects = NULL;
+//variable globale designant la zone abîmée de la root_surface, à redessiner et à mettre à jour à l'écran
+ei_region_t damage;
 
 
 
@@ -52,6 +64,9 @@ ei_linked_rect_t* rects = NULL;
 void ei_app_create(ei_size_t main_window_size, bool fullscreen){
         // initializes the hardware (calls \ref hw_init)
         hw_init();
+        ei_impl_stats_init();
+        // ouvre à l'avance les polices utilisées par les classes de widget (titre des toplevels)
+        ei_impl_font_preload(ei_default_font_filename, ei_style_normal, EI_TOPLEVEL_TITLE_FONT_SIZE);
 
         // registers all classes of widget and all geometry managers
 
@@ -65,6 +80,8 @@ void ei_app_create(ei_size_t main_window_size, bool fullscreen){
         frameclass->next             = NULL;
         strcpy(frameclass->name,(ei_widgetclass_name_t){"frame\0"});
         ei_widgetclass_register(frameclass);
+        ei_impl_widgetclass_set_opaquefunc(frameclass, ei_impl_opaque_frame);
+        ei_impl_widgetclass_set_hitfunc(frameclass, ei_impl_hit_frame);
 
         //      register button class of widget
         ei_widgetclass_t* buttonclass = calloc(1,sizeof(ei_widgetclass_t));
@@ -76,6 +93,8 @@ void ei_app_create(ei_size_t main_window_size, bool fullscreen){
         buttonclass->next             = NULL;
         strcpy(buttonclass->name,(ei_widgetclass_name_t){"button\0"});
         ei_widgetclass_register(buttonclass);
+        ei_impl_widgetclass_set_opaquefunc(buttonclass, ei_impl_opaque_button);
+        ei_impl_widgetclass_set_hitfunc(buttonclass, ei_impl_hit_button);
 
         //      register toplevel class of widget
         ei_widgetclass_t* toplevelclass = calloc(1,sizeof(ei_widgetclass_t));
@@ -87,6 +106,8 @@ void ei_app_create(ei_size_t main_window_size, bool fullscreen){
         toplevelclass->next             = NULL;
         strcpy(toplevelclass->name,(ei_widgetclass_name_t){"toplevel\0"});
         ei_widgetclass_register(toplevelclass);
+        ei_impl_widgetclass_set_opaquefunc(toplevelclass, ei_impl_opaque_toplevel);
+        ei_impl_widgetclass_set_hitfunc(toplevelclass, ei_impl_hit_toplevel);
 
         //      register entry class of widget
         ei_widgetclass_t* entryclass = calloc(1,sizeof(ei_widgetclass_t));
@@ -98,6 +119,8 @@ void ei_app_create(ei_size_t main_window_size, bool fullscreen){
         entryclass->next             = NULL;
         strcpy(entryclass->name,(ei_widgetclass_name_t){"entry\0"});
         ei_widgetclass_register(entryclass);
+        ei_impl_widgetclass_set_opaquefunc(entryclass, ei_impl_opaque_entry);
+        ei_impl_widgetclass_set_hitfunc(entryclass, ei_impl_hit_entry);
 
         //      register geometry manager "placer"
         ei_geometrymanager_t* placer = calloc(1,sizeof(ei_geometrymanager_t));
@@ -106,6 +129,13 @@ void ei_app_create(ei_size_t main_window_size, bool fullscreen){
         strcpy(placer->name,"placer\0");
         ei_geometrymanager_register(placer);
 
+        //      register geometry manager "grid"
+        ei_geometrymanager_t* grid = calloc(1,sizeof(ei_geometrymanager_t));
+        grid->runfunc              = ei_impl_grid_runfunc;
+        grid->releasefunc          = ei_impl_grid_releasefunc;
+        strcpy(grid->name,"grid\0");
+        ei_geometrymanager_register(grid);
+
         // creates the root window (either in a system window, or the entire screen
         ei_surface_t main_window= hw_create_window(main_window_size,fullscreen);
         hw_surface_lock(main_window);
@@ -116,15 +146,15 @@ void ei_app_create(ei_size_t main_window_size, bool fullscreen){
 
         ei_impl_setdefaults_frame(root);
         root->pick_id=0x000000FF;
-        root->pick_color=calloc(1,sizeof(ei_color_t));
-        root->pick_color->red = 0x00; root->pick_color->green = 0x00; root->pick_color->blue=0x00; root->pick_color->alpha=0xFF;
+        root->pick_color=(ei_color_t){0x00, 0x00, 0x00, 0xFF};
         root->parent=NULL;
         root->requested_size                    = main_window_size;
         ((ei_impl_frame_t*)root)->frame_relief  = ei_relief_none;
         root->screen_location                   = hw_surface_get_rect(main_window);
         root->requested_size                    = root->screen_location.size;
         root_surface                            = main_window;
-        pick_surface                            = hw_surface_create(root_surface, hw_surface_get_size(main_window),false);
+        //pick surface seulement en mode offscreen (sinon picking géométrique, voir ei_impl_pick.h)
+        ei_impl_pick_init(root_surface);
 }
 
 /**
@@ -143,21 +173,29 @@ void ei_app_free(void){
                 suiv=suiv->next;
         }
         free(tmp);
-        //free les geometrymanager (on en a qu'un pour le moment...
+        //free les geometrymanager
         free(ei_geometrymanager_from_name("placer\0"));
+        free(ei_geometrymanager_from_name("grid\0"));
+        ei_impl_grid_free_all();
         //on supprime nos 2 surfaces
         hw_surface_free(root_surface);
-        hw_surface_free(pick_surface);
+        free_corner_geometry_cache();
+        ei_impl_font_free_all();
+        ei_impl_text_free();
+        ei_region_free(&damage);
+        ei_impl_widgetclass_free_ext();
+        ei_impl_pick_index_free();
+        ei_impl_pick_free();
         //on supprime les binds qui restent
-        ei_bind_t* current = ei_get_head_binds();
-        ei_bind_t* tmp_bind;
-        while (current){
-                tmp_bind = current->next_bind;
-                if(!current->bind_isWidget)
-                        free(current->object.tag);
-                free(current);
-                current= tmp_bind;
-        }
+        ei_impl_binds_free();
+        ei_impl_frame_free();
+        ei_impl_timer_free();
+        ei_impl_animation_free();
+        ei_impl_record_free();
+        ei_impl_atom_free();
+        //tous les widgets sont détruits : les blocs des slabs sont rendus d'un coup
+        ei_impl_slab_free_all();
+        ei_impl_stats_exit();
         hw_quit();
 }
 
@@ -175,12 +213,44 @@ void release_linked_rect(ei_linked_rect_t* list){
 }
 
 
+/**
+ * @brief Passe de layout, puis dessin et affichage de la zone abîmée : une image de la boucle principale (sans
+ * les animations). Appelée par \ref ei_app_run, et par les benchmarks qui mesurent le coût d'une image.
+ */
+void ei_impl_app_render(void){
+        //une seule passe de layout par image, juste avant le dessin : elle abîme ce qui a bougé
+        double start = ei_impl_stats_begin();
+        ei_impl_layout_run();
+        ei_impl_stats_end(ei_stats_layout, start);
+        if (ei_region_is_empty(&damage)) return;
+
+        //on redessine exactement la zone abîmée, rectangle par rectangle
+        start = ei_impl_stats_begin();
+        hw_surface_unlock(root_surface);
+        for (int i = 0; i < damage.size; i++) {
+                ei_rect_t clipper = ei_region_rect(&damage, i);
+                ei_impl_widget_draw_children(root, root_surface, pick_surface, &clipper);
+        }
+        ei_impl_stats_end(ei_stats_draw, start);
+        start = ei_impl_stats_begin();
+        ei_linked_rect_t* updated = ei_region_to_linked_rects(&damage);
+        hw_surface_update_rects(root_surface, updated);
+        ei_impl_stats_end(ei_stats_present, start);
+        ei_impl_stats_count(ei_stats_rects_presented, damage.size);
+        // IL faut release tout les rects
+        release_linked_rect(updated);
+        ei_region_clear(&damage);
+        hw_surface_lock(root_surface);
+}
+
 /**
  * \brief	Runs the application: enters the main event loop. Exits when
  *		\ref ei_app_quit_request is called.
  */
 void ei_app_run(void){
 
+        //géométrie des widgets placés avant le lancement
+        ei_impl_layout_run();
         ei_rect_t clipper           = hw_surface_get_rect(ei_app_root_surface());
         ei_impl_widget_draw_children(root, root_surface, pick_surface, &clipper);
         hw_surface_unlock(root_surface);
@@ -199,60 +269,39 @@ void ei_app_run(void){
         ei_bind(ei_ev_mouse_buttondown, NULL,"entry\0",ei_callback_entry,NULL);
         ei_bind(ei_ev_keydown, NULL,"entry\0",ei_callback_entry,NULL);
 
+        ei_impl_frame_init();
+        //enregistrement ou rejeu des évènements (EI_RECORD, EI_REPLAY)
+        ei_impl_record_init();
         ei_event_t* event = calloc(1,sizeof(ei_event_t));
-        ei_bind_t* bind;
-        ei_bind_t* binds;
-        bool change_event = true;
         while(!quit){
-                binds=ei_get_head_binds();
-                hw_event_wait_next(event);
-                change_event = true;
-                do {
-                        bind = ei_bind_from_event(event,binds); // on cherche si on a un bind en lien avec l'evenement
-                        if (bind) {
-                                if (event->type == ei_ev_mouse_buttondown || event->type == ei_ev_mouse_buttonup || event->type == ei_ev_mouse_move) { //on regarde le type de notre event pour pouvoir utiliser mouse.where
-                                        change_event = (bind->callback)(ei_widget_pick(&event->param.mouse.where), event, bind->user_param); //on appelle notre callback
-                                }else{ // si notre event a pas de picking
-                                        change_event = (bind->callback)(NULL,event,bind->user_param);
-                                }
-                        }
-                        if (bind && ! change_event) { //si on a pas finit notre callback alors on regarde la suite
-                                binds = bind->next_bind;
-                        }
-
-
-                }while(!change_event && bind);
-                if (rects) {//on updates les rects qui ont changé dans la fenêtre
-                        hw_surface_unlock(root_surface);
-                        clipper = get_smallest_containing_rect(rects);
-                        ei_impl_widget_draw_children(root, root_surface, pick_surface, &clipper);
-                        hw_surface_update_rects(root_surface, rects);
-                        // IL faut release tout les rects
-                        release_linked_rect(rects);
-                        rects = NULL;
-                        hw_surface_lock(root_surface);
-                }
-
+                //chaque phase est chronométrée si le profiler est activé (ei_impl_stats.h)
+                double start = ei_impl_stats_begin();
+                ei_impl_record_next(event);
+                ei_impl_stats_end(ei_stats_wait, start);
+                ei_impl_stats_count(ei_stats_events, 1);
+                //table de dispatch par type d'évènement (les déplacements de souris d'une rafale sont fusionnés)
+                start = ei_impl_stats_begin();
+                ei_impl_frame_event(event);
+                ei_impl_stats_end(ei_stats_dispatch, start);
+                //au plus une image par période : les évènements suivants s'accumulent dans le layout et la damage
+                if (!ei_impl_frame_due(ei_impl_animation_active() || ei_impl_layout_pending()
+                                       || !ei_region_is_empty(&damage))) continue;
+                ei_impl_frame_presented();
+                double frame_start = ei_impl_stats_begin();
+                ei_impl_stats_count(ei_stats_frames, 1);
+                //toutes les animations avancent ensemble : leurs placements sont calculés par la même passe
+                start = ei_impl_stats_begin();
+                ei_impl_animation_step();
+                ei_impl_stats_end(ei_stats_animation, start);
+                ei_impl_app_render();
+                ei_impl_stats_end(ei_stats_frame, frame_start);
+                if (ei_impl_animation_active()) ei_impl_frame_request();
 
         }
         free(event);
 }
 
 
-/**
- * @brief ajoute a la tete de la liste de rectangle a update un rectangle
- * @param rect
- */
-void add_head_rects(const ei_rect_t* rect){
-        ei_linked_rect_t* new_rect = calloc(1,sizeof(ei_linked_rect_t));
-        ei_rect_t rect_correction = get_rect_intersection(*rect, root->screen_location);
-        new_rect->next = rects;
-        new_rect->rect.top_left.x = rect_correction.top_left.x;
-        new_rect->rect.top_left.y = rect_correction.top_left.y;
-        new_rect->rect.size.width = rect_correction.size.width;
-        new_rect->rect.size.height = rect_correction.size.height;
-        rects = new_rect;
-}
 /**
  * \brief	Adds a rectangle to the list of rectangles that must be updated on screen. The real
  *		update on the screen will be done at the right moment in the main loop.
@@ -261,49 +310,11 @@ void add_head_rects(const ei_rect_t* rect){
  *				A copy is made, so it is safe to release the rectangle on return.
  */
 void ei_app_invalidate_rect(const ei_rect_t* rect){
-        ei_rect_t rect_correct = get_rect_intersection(*(ei_rect_t*)rect,root->screen_location);
-        if (!rects) {
-                add_head_rects(&rect_correct);
-                return;
-        }
-        ei_linked_rect_t* prec = rects;
-        ei_linked_rect_t* current;
-        ei_rect_t inter;
-        inter=get_rect_intersection(prec->rect,rect_correct);
-        if (inter.size.width == (prec->rect).size.width &&
-            inter.size.height == (prec->rect).size.height &&
-            inter.top_left.x == (prec->rect).top_left.x &&
-            inter.top_left.y == (prec->rect).top_left.y){
-
-                rects = rects->next;
-                free(prec);
-                ei_app_invalidate_rect(rect);
-                return;
-        }
-        while(prec->next){
-                current=prec->next;
-                inter=get_rect_intersection(current->rect,rect_correct);
-                // si l'intersection entre le nouveau rectangle et current est le rect current alors on supprime current (current est inclu dans le nouveau rect)
-                if (inter.size.width  == (current->rect).size.width  &&
-                    inter.size.height == (current->rect).size.height &&
-                    inter.top_left.x  == (current->rect).top_left.x  &&
-                    inter.top_left.y  == (current->rect).top_left.y){
-
-                        prec->next = current->next;
-                        free(current);
-
-                }
-                // si l'intersection entre le nouveau rectangle et current est le nouveau rectangle alors on ajoute pas le nouveau rectangle(current contient le nouveau rect)
-                else if (inter.size.width == (rect_correct).size.width &&
-                    inter.size.height == (rect_correct).size.height &&
-                    inter.top_left.x == (rect_correct).top_left.x &&
-                    inter.top_left.y == (rect_correct).top_left.y){
-
-                        return;
-                }
-                prec = current;
-        }
-        add_head_rects(&rect_correct);
+        //la région fusionne les rectangles qui se recouvrent : chaque pixel abîmé n'y est qu'une fois
+        ei_rect_t rect_correct = get_rect_intersection(*rect, root->screen_location);
+        ei_region_union_rect(&damage, &rect_correct);
+        //ce qui est redessiné a pu bouger : l'index du picking géométrique est à reconstruire
+        ei_impl_pick_invalidate();
 }
 
 /**
@@ -12,6 +12,51 @@
 
 #include "ei_draw.h"
 #include "ei_outil_geom.h"
+#include "ei_impl_blend.h"
+#include "ei_impl_raster.h"
+#include "ei_impl_stats.h"
+
+/**
+ * \brief	Draws a line that can be made of many line segments.
+ *
+ * @param	surface 	Where to draw the line. The surface must be *locked* by
+ *				\ref hw_surface_lock.
+ * @param	point_array 	The array of points defining the polyline. Its size is provided in the
+ * 				next parameter (point_array_size). The array can be empty (i.e. nothing
+ * 				is drawn) or it can have a single point, or more.
+ *				If the last point is the same as the first point, then this pixel is
+ *				drawn only once.
+ * @param	point_array_size The number of points in the point_array. Can be 0.
+ * @param	color		The color used to draw the line. The alpha channel is managed.
+ * @param	clipper		If not NULL, the drawing is restricted within this rectangle.
+ */
+void	ei_draw_polyline	(ei_surface_t		surface,
+				 ei_point_t*		point_array,
+				 size_t			point_array_size,
+				 ei_color_t		color,
+				 const ei_rect_t*	clipper){
+        ei_impl_raster_polyline(surface, point_array, point_array_size, color, clipper);
+}
+
+/**
+ * \brief	Draws a filled polygon.
+ *
+ * @param	surface 	Where to draw the polygon. The surface must be *locked* by
+ *				\ref hw_surface_lock.
+ * @param	point_array 	The array of points defining the polygon. Its size is provided in the
+ * 				next parameter (point_array_size). The array can be empty (i.e. nothing
+ * 				is drawn) or else it must have more than 2 points.
+ * @param	point_array_size The number of points in the point_array. Must be 0 or more than 2.
+ * @param	color		The color used to draw the polygon. The alpha channel is managed.
+ * @param	clipper		If not NULL, the drawing is restricted within this rectangle.
+ */
+void	ei_draw_polygon		(ei_surface_t		surface,
+				 ei_point_t*		point_array,
+				 size_t			point_array_size,
+				 ei_color_t		color,
+				 const ei_rect_t*	clipper){
+        ei_impl_raster_polygon(surface, point_array, point_array_size, color, clipper);
+}
 
 /**
  * \brief	Draws text by calling \ref hw_text_create_surface.
@@ -32,24 +77,10 @@ void	ei_draw_text		(ei_surface_t		surface,
 				 ei_font_t		font,
 				 ei_color_t		color,
 				 const ei_rect_t*	clipper){
-        //creation de la surface de texte a copier
-        ei_surface_t surfacetext = hw_text_create_surface(text,font,color);
-        ei_rect_t rect_text = (ei_rect_t){*where, hw_surface_get_size(surfacetext)};
-        //pour ei_copy_surface il faut les surfaces lock.
+        //le texte est composé à partir de l'atlas de glyphes de la police : pas de surface temporaire
         hw_surface_lock(surface);
-        hw_surface_lock(surfacetext);
-        ei_rect_t dst_rect = get_rect_intersection(*clipper,rect_text);
-        int decalage_x = abs(dst_rect.top_left.x - rect_text.top_left.x);
-        int decalage_y = abs(dst_rect.top_left.y - rect_text.top_left.y);
-        ei_copy_surface(surface, &dst_rect, surfacetext, &(ei_rect_t){{decalage_x,decalage_y},dst_rect.size}, true);
-
-        //on unlock les surfaces
+        ei_impl_text_draw(surface, *where, text, font, color, clipper);
         hw_surface_unlock(surface);
-        hw_surface_unlock(surfacetext);
-        //on libere la surface qu'on avait allouée pour le texte.
-        hw_surface_free(surfacetext);
-
-
 }
 
 /**
@@ -64,22 +95,25 @@ void	ei_draw_text		(ei_surface_t		surface,
 void	ei_fill			(ei_surface_t		surface,
 				 const ei_color_t*	color,
 				 const ei_rect_t*	clipper){
+        ei_color_t fill_color = color ? *color : (ei_color_t){0, 0, 0, 0xFF};
+        ei_rect_t surf_rect = hw_surface_get_rect(surface);
+        ei_rect_t rect = (ei_rect_t){{0, 0}, surf_rect.size};
+        if (clipper) rect = get_rect_intersection(*clipper, rect);
+        if (rect.size.width <= 0 || rect.size.height <= 0) return;
 
-        if (clipper){
-                ei_point_t array[4] ={ {clipper->top_left.x,clipper->top_left.y},
-                                     {clipper->top_left.x + clipper->size.width, clipper->top_left.y},
-                                     {clipper->top_left.x + clipper->size.width, clipper->top_left.y + clipper->size.height},
-                                     {clipper->top_left.x, clipper->top_left.y + clipper->size.height}};
-                if (color) ei_draw_polygon(surface,array,4,*color,clipper);
-                else ei_draw_polygon(surface,array,4,(ei_color_t){0,0,0,0xFF},clipper);
-        }else{
-                ei_size_t size = hw_surface_get_size(surface);
-                ei_point_t array[4] ={ {0,0},
-                                       {size.width, 0},
-                                       {size.width, size.height},
-                                       {0, size.height}};
-                if (color) ei_draw_polygon(surface,array,4,*color,clipper);
-                else ei_draw_polygon(surface,array,4,(ei_color_t){0,0,0,0xFF},clipper);
+        //rectangle aligné sur les axes : on écrit directement les lignes de pixels, sans passer par ei_draw_polygon
+        uint32_t* first = (uint32_t*)hw_surface_get_buffer(surface)
+                          + rect.top_left.x + (size_t)rect.top_left.y * surf_rect.size.width;
+        uint32_t pixel = ei_impl_map_rgba(surface, fill_color);
+
+        if (fill_color.alpha == 0xFF) {
+                ei_impl_fill_rows(first, surf_rect.size.width, rect.size.width, rect.size.height, pixel);
+        } else {
+                int ir, ig, ib, ia;
+                hw_surface_get_channel_indices(surface, &ir, &ig, &ib, &ia);
+                ei_impl_blend_fill_rows(first, surf_rect.size.width, rect.size.width, rect.size.height,
+                                        pixel, fill_color.alpha, ia < 0 ? 0 : (uint32_t)0xFF << (8 * ia));
+                ei_impl_stats_count(ei_stats_pixels_blended, (uint64_t)rect.size.width * rect.size.height);
         }
 }
 
@@ -113,70 +147,46 @@ int	ei_copy_surface		(ei_surface_t		destination,
 				 bool			alpha){
 
         /*On initialise les valeurs dont on aura besoin...*/
-        uint32_t *pixel_dst = (uint32_t*)hw_surface_get_buffer(destination);
-        uint32_t *pixel_src = (uint32_t*)hw_surface_get_buffer(source);
-        int x_dst,y_dst,x_src,y_src, width_src, width_dst, height_src, height_dst;
         ei_rect_t dst_surf_rect = hw_surface_get_rect(destination);
         ei_rect_t src_surf_rect = hw_surface_get_rect(source);
-        if (src_rect){
-                x_src = src_rect->top_left.x;
-                y_src = src_rect->top_left.y;
-                width_src = src_rect->size.width;
-                height_src = src_rect->size.height;
-        }else{
-                x_src = 0;
-                y_src = 0;
-                width_src = src_surf_rect.size.width;
-                height_src = src_surf_rect.size.height;
-        }
-        if (dst_rect) {
-                x_dst = dst_rect->top_left.x;
-                y_dst = dst_rect->top_left.y;
-                width_dst = dst_rect->size.width;
-                height_dst = dst_rect->size.height;
-        }else{
-                x_dst = 0;
-                y_dst = 0;
-                width_dst = dst_surf_rect.size.width;
-                height_dst = dst_surf_rect.size.height;
-        }
-        pixel_dst= pixel_dst + x_dst + y_dst*dst_surf_rect.size.width;
-        pixel_src = pixel_src + x_src + y_src*src_surf_rect.size.width;
-        uint8_t *red_dst, *green_dst, *blue_dst, *alpha_dst;
-        uint8_t *red_src, *green_src, *blue_src, alpha_src;
-        /*On copie la source dans la destination*/
+        ei_rect_t dst = dst_rect ? *dst_rect : (ei_rect_t){{0, 0}, dst_surf_rect.size};
+        ei_rect_t src = src_rect ? *src_rect : (ei_rect_t){{0, 0}, src_surf_rect.size};
+
         //on est pas sensé avoir des tailles differentes..
-        if (width_dst != width_src || height_dst != height_src) {
+        if (dst.size.width != src.size.width || dst.size.height != src.size.height) {
                 printf("probleme");
                 return 1;
         }
-        //utile si taille differente mais ducoup inutile
-        int min_width = width_src < width_dst ? width_src : width_dst;
-        int min_height = height_src < height_dst ? height_src : height_dst;
-
-        for (int y=0; y < min_height; y++){
-                for (int x=0; x < min_width; x++){
-                        if (x + x_dst < dst_surf_rect.size.width &&
-                            x + x_dst >= dst_surf_rect.top_left.x &&
-                            y + y_dst >= dst_surf_rect.top_left.y &&
-                            y+y_dst<dst_surf_rect.size.height) {
-                                // On sait que les pixel sont encodés sur 32bits, 8bits par channel,
-                                // alors on peut acceder au 4 channels de la sorte
-                                red_dst = (uint8_t *) (pixel_dst + x + y * dst_surf_rect.size.width);
-                                green_dst = red_dst + 1;
-                                blue_dst = red_dst + 2;
-                                //alpha_dst = red_dst + 3;
-                                red_src = (uint8_t *) (pixel_src + x + y * src_surf_rect.size.width);
-                                green_src = red_src + 1;
-                                blue_src = red_src + 2;
-                                if (alpha) alpha_src = *(red_src + 3);
-                                else alpha_src = 0xFF;
-                                *(red_dst) = ((*red_dst) * (255 - (alpha_src)) + (*red_src) * (alpha_src)) / 255;
-                                *(green_dst) = ((*green_dst) * (255 - (alpha_src)) + (*green_src) * (alpha_src)) / 255;
-                                *(blue_dst) = ((*blue_dst) * (255 - (alpha_src)) + (*blue_src) * (alpha_src)) / 255;
-                        }
-                }
-        }
+
+        /*On clippe une seule fois : [left,right[ x [top,bottom[ est la partie du rectangle a copier
+         * qui tombe a la fois dans la surface destination et dans la surface source*/
+        int left = 0, top = 0;
+        int right = dst.size.width, bottom = dst.size.height;
+        if (-dst.top_left.x > left) left = -dst.top_left.x;
+        if (-src.top_left.x > left) left = -src.top_left.x;
+        if (-dst.top_left.y > top)  top  = -dst.top_left.y;
+        if (-src.top_left.y > top)  top  = -src.top_left.y;
+        if (dst_surf_rect.size.width  - dst.top_left.x < right)  right  = dst_surf_rect.size.width  - dst.top_left.x;
+        if (src_surf_rect.size.width  - src.top_left.x < right)  right  = src_surf_rect.size.width  - src.top_left.x;
+        if (dst_surf_rect.size.height - dst.top_left.y < bottom) bottom = dst_surf_rect.size.height - dst.top_left.y;
+        if (src_surf_rect.size.height - src.top_left.y < bottom) bottom = src_surf_rect.size.height - src.top_left.y;
+        if (right <= left || bottom <= top) return 0;
+
+        uint32_t *pixel_dst = (uint32_t*)hw_surface_get_buffer(destination)
+                              + (dst.top_left.x + left) + (size_t)(dst.top_left.y + top) * dst_surf_rect.size.width;
+        uint32_t *pixel_src = (uint32_t*)hw_surface_get_buffer(source)
+                              + (src.top_left.x + left) + (size_t)(src.top_left.y + top) * src_surf_rect.size.width;
+
+        // position du canal alpha dans un pixel source (-1 si la source n'en a pas)
+        int ir, ig, ib, ia;
+        hw_surface_get_channel_indices(source, &ir, &ig, &ib, &ia);
+
+        /*On copie la source dans la destination, ligne par ligne*/
+        ei_impl_blend_rows(pixel_dst, dst_surf_rect.size.width,
+                           pixel_src, src_surf_rect.size.width,
+                           right - left, bottom - top,
+                           ia < 0 ? -1 : 8 * ia, alpha);
+        if (alpha && ia >= 0) ei_impl_stats_count(ei_stats_pixels_blended, (uint64_t)(right - left) * (bottom - top));
         return 0;
 }
 
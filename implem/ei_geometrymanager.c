@@ -12,6 +12,7 @@
 #include "ei_geometrymanager.h"
 #include "ei_implementation.h"
 #include "var.h"
+#include "ei_impl_layout.h"
 
 
 /**
@@ -38,7 +39,7 @@ size_t		ei_geom_param_size(){
  * 		the widget (size and/or position). If there was a change:
  * 			* schedule a redraw of the screen on the old and new screen location
  * 			* notify the widget that it's geometry has changed
- * 			* recompute the geometry of the children
+ * 			* mark the children so that their geometry is recomputed by the layout pass
  *
  * @param	widget		The which geometry computation has been done.
  * @param	computed_screen_location The new screen location computed by the run of the
@@ -51,17 +52,15 @@ void			ei_geometry_run_finalize(ei_widget_t widget, ei_rect_t* new_screen_locati
             widget->screen_location.size.height!= new_screen_location->size.height||
             widget->screen_location.size.width != new_screen_location->size.width){
                 //alors la geometrie a changée
+                //on prevoie un redraw de l'ancienne et de la nouvelle surface (seulement ce qui a bougé)
+                ei_app_invalidate_rect(&widget->screen_location);
+                ei_app_invalidate_rect(new_screen_location);
                 //on met a jour la screen location
                 widget->screen_location = *new_screen_location;
-                //on prevoie un redraw (si le widget est manager par un geometrymanager)
                 //on notifie le widget qu'on a changé sa géométrie
                 if (widget->wclass->geomnotifyfunc)(widget->wclass->geomnotifyfunc)(widget);
-                //on recalcule la géométrie des enfants
-                ei_widget_t child = widget->children_head;
-                while (child){
-                        if ((child->geom_params) && (child->geom_params->manager)) (child->geom_params->manager->runfunc)(child);
-                        child=child->next_sibling;
-                }
+                //la géométrie des enfants sera recalculée dans la même passe de layout
+                ei_impl_layout_mark_children(widget);
 
                 widget->screen_location = *new_screen_location;
         }
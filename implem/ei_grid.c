@@ -0,0 +1,159 @@
+/**
+ *  @file	ei_grid.c
+ *  @brief	Manages the positioning and sizing of widgets in rows and columns (tile boards, forms).
+ *
+ */
+
+#include "ei_grid.h"
+#include "ei_implementation.h"
+#include "ei_geometrymanager.h"
+#include "ei_impl_grid.h"
+#include "ei_impl_layout.h"
+#include "ei_impl_atom.h"
+
+
+/*
+ * Les widgets créés dans un toplevel sont les enfants de sa frame de contenu : c'est elle qui a la grille.
+ */
+static ei_widget_t grid_container(ei_widget_t container){
+        if (ei_impl_widget_is(container, ei_atom_toplevel) && ((ei_impl_toplevel_t*)container)->contain_frame)
+                return ((ei_impl_toplevel_t*)container)->contain_frame;
+        return container;
+}
+
+/**
+ * \brief	Configures the geometry of a widget using the "grid" geometry manager.
+ *
+ *		The grid divides the parent's *content_rect* into rows and columns (the tracks). The
+ *		size of a track is the largest size needed by the widgets in it (their requested size
+ *		plus their padding), at least the minimum size of the track. When the parent is larger
+ *		than the sum of the tracks, the remaining space is shared by the tracks that have a
+ *		weight, in proportion to their weight (see \ref ei_grid_rowconfigure).
+ *
+ * 		If the widget was already managed by the "grid", then this calls simply updates
+ *		the grid parameters: arguments that are not NULL replace previous values.
+ *		Arguments that are NULL don't change the current value of the parameter.
+ *		Calling this function again after changing the requested size of the widget updates
+ *		the size of its row and column.
+ *
+ * @param	widget		The widget to place.
+ * @param	row		The row of the top-left cell of the widget (defaults to 0).
+ * @param	column		The column of the top-left cell of the widget (defaults to 0).
+ * @param	row_span	The number of rows covered by the widget (defaults to 1).
+ * @param	column_span	The number of columns covered by the widget (defaults to 1).
+ * @param	padx		The space left empty on the left and right of the widget, in its cell
+ *				(defaults to 0).
+ * @param	pady		The space left empty above and under the widget, in its cell
+ *				(defaults to 0).
+ * @param	anchor		Where to put the widget in its cell, at its requested size. With
+ *				ei_anc_none, the widget fills its cell (defaults to ei_anc_none).
+ */
+void		ei_grid		(ei_widget_t		widget,
+				 int*			row,
+				 int*			column,
+				 int*			row_span,
+				 int*			column_span,
+				 int*			padx,
+				 int*			pady,
+				 ei_anchor_t*		anchor){
+        if (!widget || !widget->parent) return;
+        //géré par un autre gestionnaire : il l'oublie d'abord
+        ei_geometrymanager_t* manager = ei_geometrymanager_from_name("grid\0");
+        if (widget->geom_params && widget->geom_params->manager != manager)
+                ei_geometrymanager_unmap(widget);
+
+        ei_impl_grid_cell_t* cell = (ei_impl_grid_cell_t*)widget->geom_params;
+        bool new_placement = cell==NULL;
+        ei_impl_grid_t* grid;
+        if (new_placement){
+                grid = ei_impl_grid_of(widget->parent, true);
+                cell = ei_impl_slab_alloc(&ei_impl_grid_slab);
+                cell->widget = widget;
+                cell->span[0] = cell->span[1] = 1;
+                cell->anchor = ei_anc_none;
+                ei_widget_set_geom_params(widget,(ei_geom_param_t)cell);
+                ei_widget_set_geom_manager(widget,manager);
+        } else {
+                grid = cell->grid;
+                ei_impl_grid_detach(cell);
+        }
+
+        if (column && *column >= 0) cell->pos[0] = *column;
+        if (row && *row >= 0) cell->pos[1] = *row;
+        if (column_span && *column_span >= 1) cell->span[0] = *column_span;
+        if (row_span && *row_span >= 1) cell->span[1] = *row_span;
+        if (padx && *padx >= 0) cell->pad[0] = *padx;
+        if (pady && *pady >= 0) cell->pad[1] = *pady;
+        if (anchor) cell->anchor = *anchor;
+
+        //les pistes de l'ancienne et de la nouvelle position sont à recalculer, le reste de la grille non ;
+        //les autres cellules ne sont replacées que si une piste change (ei_impl_grid_prepare)
+        ei_impl_grid_attach(grid, cell);
+
+        if (new_placement) widget->layout_flags |= ei_impl_layout_new;
+        ei_impl_layout_mark(widget);
+        ei_impl_layout_mark_children(widget);
+}
+
+/*
+ * Configure une piste de la grille de container.
+ */
+static void configure_track(ei_widget_t container, int dim, int index, int* min_size, float* weight){
+        if (!container || index < 0) return;
+        ei_impl_grid_t* grid = ei_impl_grid_of(grid_container(container), true);
+        ei_impl_grid_track_t* track = ei_impl_grid_track(grid, dim, index);
+        if (min_size) track->min_size = *min_size;
+        if (weight) track->weight = *weight;
+        track->dirty = true;
+        ei_impl_grid_invalidate(grid);
+}
+
+/**
+ * \brief	Configures a row of the grid of a container.
+ *
+ * @param	container	The parent of the widgets managed by the grid.
+ * @param	row		The row to configure.
+ * @param	min_size	The minimum height of the row, also its height when it is empty
+ *				(defaults to 0).
+ * @param	weight		The share of the remaining height given to this row (defaults to 0).
+ */
+void		ei_grid_rowconfigure	(ei_widget_t	container,
+					 int		row,
+					 int*		min_size,
+					 float*		weight){
+        configure_track(container, 1, row, min_size, weight);
+}
+
+/**
+ * \brief	Configures a column of the grid of a container.
+ *
+ * @param	container	The parent of the widgets managed by the grid.
+ * @param	column		The column to configure.
+ * @param	min_size	The minimum width of the column, also its width when it is empty
+ *				(defaults to 0).
+ * @param	weight		The share of the remaining width given to this column (defaults to 0).
+ */
+void		ei_grid_columnconfigure	(ei_widget_t	container,
+					 int		column,
+					 int*		min_size,
+					 float*		weight){
+        configure_track(container, 0, column, min_size, weight);
+}
+
+/**
+ * \brief	Makes all the rows and/or all the columns of the grid of a container the same size
+ *		(the size of the largest one), as on a tile board.
+ *
+ * @param	container	The parent of the widgets managed by the grid.
+ * @param	rows		If not NULL, whether all the rows have the same height (defaults to false).
+ * @param	columns		If not NULL, whether all the columns have the same width (defaults to false).
+ */
+void		ei_grid_uniform		(ei_widget_t	container,
+					 bool*		rows,
+					 bool*		columns){
+        if (!container) return;
+        ei_impl_grid_t* grid = ei_impl_grid_of(grid_container(container), true);
+        if (columns) grid->uniform[0] = *columns;
+        if (rows) grid->uniform[1] = *rows;
+        ei_impl_grid_invalidate(grid);
+}
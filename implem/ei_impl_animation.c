@@ -0,0 +1,191 @@
+/**
+ * @file	ei_impl_animation.c
+ *
+ * @brief 	Moteur d'animation : avance les animations en cours une fois par image.
+ */
+
+#include <stdlib.h>
+#include "ei_impl_animation.h"
+#include "ei_impl_slab.h"
+#include "ei_impl_atom.h"
+#include "ei_placer.h"
+#include "ei_geometrymanager.h"
+#include "ei_widget_configure.h"
+#include "ei_application.h"
+#include "hw_interface.h"
+
+static ei_impl_slab_t           animation_slab  = EI_IMPL_SLAB_INIT(sizeof(ei_impl_animation_t));
+static ei_impl_animation_t**    animations      = NULL;
+static int                      nb_animations   = 0;
+static int                      capacity        = 0;
+static ei_impl_animation_t*     finished        = NULL;  ///< terminées pendant l'image, done pas encore appelée
+
+
+/*
+ * Couleur de fond du widget, NULL si sa classe n'en a pas.
+ */
+static ei_color_t* widget_color(ei_widget_t widget){
+        if (ei_impl_widget_is(widget, ei_atom_frame) || ei_impl_widget_is(widget, ei_atom_button))
+                return &((ei_impl_frame_t*)widget)->frame_color;
+        if (ei_impl_widget_is(widget, ei_atom_toplevel))
+                return &((ei_impl_toplevel_t*)widget)->color;
+        return NULL;
+}
+
+static void remove_at(int i){
+        animations[i]->index = -1;
+        animations[i] = animations[--nb_animations];
+        animations[i]->index = i;
+}
+
+/**
+ * @brief Démarre une animation remplie par l'appelant (widget, propriété, valeurs de fin, durée...) :
+ * lit les valeurs de départ et remplace l'animation de la même propriété du widget.
+ */
+ei_impl_animation_t* ei_impl_animation_start(ei_impl_animation_t* model){
+        for (int i = 0; i < nb_animations; i++){
+                if (animations[i]->widget == model->widget && animations[i]->property == model->property){
+                        ei_impl_animation_remove(animations[i]);
+                        break;
+                }
+        }
+        ei_impl_animation_t* animation = ei_impl_slab_alloc(&animation_slab);
+        *animation = *model;
+        animation->start = hw_now();
+        if (animation->property == ei_impl_animation_place){
+                ei_placer_t* placer = (ei_placer_t*)animation->widget->geom_params;
+                ei_size_t size = animation->widget->screen_location.size;
+                //largeur et hauteur nulles : le placer garde la taille courante, l'animation part d'elle
+                animation->from[0] = placer->x;
+                animation->from[1] = placer->y;
+                animation->from[2] = placer->width ? placer->width : size.width;
+                animation->from[3] = placer->height ? placer->height : size.height;
+        } else {
+                animation->from_color = *widget_color(animation->widget);
+        }
+        if (nb_animations == capacity){
+                capacity = capacity ? 2*capacity : 32;
+                animations = realloc(animations, capacity * sizeof(ei_impl_animation_t*));
+        }
+        animation->index = nb_animations;
+        animations[nb_animations++] = animation;
+        return animation;
+}
+
+/**
+ * @brief Arrête une animation (ou marque annulée une animation terminée dont done n'a pas encore été appelée).
+ */
+void ei_impl_animation_remove(ei_impl_animation_t* animation){
+        if (!animation) return;
+        if (animation->index < 0){
+                animation->cancelled = true;
+                return;
+        }
+        remove_at(animation->index);
+        ei_impl_slab_free(&animation_slab, animation);
+}
+
+/**
+ * @brief Dit si des animations sont en cours (une image doit être produite à chaque période).
+ */
+bool ei_impl_animation_active(void){
+        return nb_animations > 0;
+}
+
+static double ease(ei_easing_t easing, double t){
+        switch (easing){
+                case ei_ease_in:        return t*t;
+                case ei_ease_out:       return 1 - (1-t)*(1-t);
+                case ei_ease_in_out:    return t*t*(3 - 2*t);
+                default:                return t;
+        }
+}
+
+static int mix(int from, int to, double t){
+        return from + (int)((to - from) * t + (to >= from ? 0.5 : -0.5));
+}
+
+/*
+ * Applique l'animation à l'avancement t (entre 0 et 1). Rien n'est marqué ni abîmé si la valeur ne change pas.
+ */
+static void apply(ei_impl_animation_t* animation, double t){
+        ei_widget_t widget = animation->widget;
+        if (animation->property == ei_impl_animation_place){
+                //oublié par le placer pendant l'animation : plus rien à placer
+                if (!widget->geom_params || widget->geom_params->manager != ei_geometrymanager_from_name("placer\0")) return;
+                ei_placer_t* placer = (ei_placer_t*)widget->geom_params;
+                int current[4] = {placer->x, placer->y, placer->width, placer->height};
+                int value[4];
+                bool changed = false;
+                for (int k = 0; k < 4; k++){
+                        value[k] = animation->animated[k] ? mix(animation->from[k], animation->to[k], t) : current[k];
+                        changed |= value[k] != current[k];
+                }
+                if (changed) ei_place(widget, NULL, &value[0], &value[1],
+                                      animation->animated[2] ? &value[2] : NULL,
+                                      animation->animated[3] ? &value[3] : NULL,
+                                      NULL, NULL, NULL, NULL);
+        } else {
+                ei_color_t* color = widget_color(widget);
+                ei_color_t from = animation->from_color, to = animation->to_color;
+                ei_color_t value = {mix(from.red, to.red, t), mix(from.green, to.green, t),
+                                    mix(from.blue, to.blue, t), mix(from.alpha, to.alpha, t)};
+                if (value.red == color->red && value.green == color->green && value.blue == color->blue
+                    && value.alpha == color->alpha) return;
+                *color = value;
+                ei_app_invalidate_rect(&widget->screen_location);
+        }
+}
+
+/**
+ * @brief Avance toutes les animations à l'instant présent, puis appelle done pour celles qui sont terminées.
+ * Appelée par \ref ei_app_run au début de chaque image, avant la passe de layout.
+ */
+void ei_impl_animation_step(void){
+        double now = hw_now();
+        int i = 0;
+        while (i < nb_animations){
+                ei_impl_animation_t* animation = animations[i];
+                double t = animation->duration > 0 ? (now - animation->start) / animation->duration : 1;
+                if (t < 1){
+                        apply(animation, ease(animation->easing, t < 0 ? 0 : t));
+                        i++;
+                        continue;
+                }
+                apply(animation, 1);
+                remove_at(i);
+                animation->next = finished;
+                finished = animation;
+        }
+        //les callbacks sont appelés une fois toutes les valeurs de l'image posées : ils peuvent démarrer
+        //ou annuler des animations, et détruire des widgets
+        while (finished){
+                ei_impl_animation_t* animation = finished;
+                finished = animation->next;
+                if (!animation->cancelled && animation->done) animation->done(animation->widget, animation->user_param);
+                ei_impl_slab_free(&animation_slab, animation);
+        }
+}
+
+/**
+ * @brief Arrête les animations de widget (appelée par \ref ei_widget_destroy).
+ */
+void ei_impl_animation_forget(ei_widget_t widget){
+        int i = 0;
+        while (i < nb_animations){
+                if (animations[i]->widget == widget) ei_impl_animation_remove(animations[i]);
+                else i++;
+        }
+        for (ei_impl_animation_t* animation = finished; animation; animation = animation->next)
+                if (animation->widget == widget) animation->cancelled = true;
+}
+
+/**
+ * @brief Libère les animations en cours (appelée par \ref ei_app_free).
+ */
+void ei_impl_animation_free(void){
+        for (int i = 0; i < nb_animations; i++) ei_impl_slab_free(&animation_slab, animations[i]);
+        free(animations);
+        animations = NULL;
+        nb_animations = capacity = 0;
+}
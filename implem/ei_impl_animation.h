@@ -0,0 +1,78 @@
+/**
+ * @file	ei_impl_animation.h
+ *
+ * @brief 	Moteur d'animation : les animations en cours sont avancées toutes ensemble, une fois par image,
+ *		juste avant la passe de layout (\ref ei_impl_animation_step). Une animation de placement passe
+ *		par \ref ei_place : la passe de layout ne recalcule chaque widget qu'une fois et n'abîme que
+ *		l'ancienne et la nouvelle position des widgets qui ont bougé. Une animation de couleur n'abîme
+ *		que le widget.
+ */
+
+#ifndef PROJETC_IG_EI_IMPL_ANIMATION_H
+#define PROJETC_IG_EI_IMPL_ANIMATION_H
+
+#include "ei_implementation.h"
+#include "ei_animation.h"
+
+/**
+ * @brief Propriété animée.
+ */
+typedef enum {
+        ei_impl_animation_place,
+        ei_impl_animation_color
+} ei_impl_animation_property_t;
+
+/**
+ * @brief Une animation. Pour le placement, les tableaux sont indexés par x, y, width, height.
+ */
+typedef struct ei_impl_animation_t {
+        ei_widget_t                     widget;
+        ei_impl_animation_property_t    property;
+        double                          start;          ///< début (secondes, horloge de \ref hw_now)
+        double                          duration;       ///< secondes
+        ei_easing_t                     easing;
+        int                             from[4];
+        int                             to[4];
+        bool                            animated[4];    ///< paramètres du placer animés
+        ei_color_t                      from_color;
+        ei_color_t                      to_color;
+        ei_animation_callback_t         done;
+        ei_user_param_t                 user_param;
+        int                             index;          ///< place dans le tableau des animations, -1 si terminée
+        bool                            cancelled;      ///< annulée entre sa fin et l'appel de done
+        struct ei_impl_animation_t*     next;           ///< liste des animations terminées pendant l'image
+} ei_impl_animation_t;
+
+/**
+ * @brief Démarre une animation remplie par l'appelant (widget, propriété, valeurs de fin, durée...) :
+ * lit les valeurs de départ et remplace l'animation de la même propriété du widget.
+ */
+ei_impl_animation_t* ei_impl_animation_start(ei_impl_animation_t* model);
+
+/**
+ * @brief Arrête une animation (ou marque annulée une animation terminée dont done n'a pas encore été appelée).
+ */
+void ei_impl_animation_remove(ei_impl_animation_t* animation);
+
+/**
+ * @brief Dit si des animations sont en cours (une image doit être produite à chaque période).
+ */
+bool ei_impl_animation_active(void);
+
+/**
+ * @brief Avance toutes les animations à l'instant présent, puis appelle done pour celles qui sont terminées.
+ * Appelée par \ref ei_app_run au début de chaque image, avant la passe de layout.
+ */
+void ei_impl_animation_step(void);
+
+/**
+ * @brief Arrête les animations de widget (appelée par \ref ei_widget_destroy).
+ */
+void ei_impl_animation_forget(ei_widget_t widget);
+
+/**
+ * @brief Libère les animations en cours (appelée par \ref ei_app_free).
+ */
+void ei_impl_animation_free(void);
+
+#endif //PROJETC_IG_EI_IMPL_ANIMATION_H
@@ -0,0 +1,122 @@
+/**
+ * @file	ei_impl_atom.c
+ *
+ * @brief 	Table des atomes : un tableau d'entrées indexé par l'atome, et une table de hachage à adressage
+ *		ouvert (FNV-1a, sondage linéaire) qui donne l'atome d'un nom.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ei_impl_atom.h"
+
+ei_impl_atom_entry_t*   ei_impl_atoms   = NULL;
+static uint32_t         nb_atoms        = 0;
+static uint32_t         atoms_capacity  = 0;
+static ei_atom_t*       slots           = NULL;  ///< table de hachage : atome ou 0 si la case est libre
+static uint32_t         slots_capacity  = 0;     ///< puissance de 2
+
+static const char* predefined[] = { "frame", "button", "toplevel", "entry", "all" };
+
+
+static uint32_t hash_name(const char* name){
+        uint32_t hash = 2166136261u;
+        for (const unsigned char* c = (const unsigned char*)name; *c; c++){
+                hash ^= *c;
+                hash *= 16777619u;
+        }
+        return hash;
+}
+
+/*
+ * Case de la table de hachage où est (ou serait) le nom.
+ */
+static uint32_t find_slot(const char* name, uint32_t hash){
+        uint32_t mask = slots_capacity - 1;
+        uint32_t slot = hash & mask;
+        while (slots[slot] != ei_atom_none){
+                ei_impl_atom_entry_t* entry = &ei_impl_atoms[slots[slot]];
+                if (entry->hash == hash && strcmp(entry->name, name) == 0) break;
+                slot = (slot + 1) & mask;
+        }
+        return slot;
+}
+
+static void grow_slots(void){
+        uint32_t capacity = slots_capacity ? 2 * slots_capacity : 64;
+        free(slots);
+        slots = calloc(capacity, sizeof(ei_atom_t));
+        slots_capacity = capacity;
+        for (ei_atom_t atom = 1; atom < nb_atoms; atom++)
+                slots[find_slot(ei_impl_atoms[atom].name, ei_impl_atoms[atom].hash)] = atom;
+}
+
+static ei_atom_t add_atom(const char* name, uint32_t hash){
+        if (nb_atoms == atoms_capacity){
+                atoms_capacity = atoms_capacity ? 2 * atoms_capacity : 32;
+                ei_impl_atoms = realloc(ei_impl_atoms, atoms_capacity * sizeof(ei_impl_atom_entry_t));
+        }
+        ei_atom_t atom = nb_atoms++;
+        ei_impl_atoms[atom] = (ei_impl_atom_entry_t){strdup(name), hash, NULL};
+        //table de hachage remplie au plus aux trois quarts
+        if (4 * nb_atoms > 3 * slots_capacity) grow_slots();
+        else slots[find_slot(name, hash)] = atom;
+        return atom;
+}
+
+/*
+ * Crée la table au premier appel, avec l'atome 0 (aucun nom) et les noms prédéfinis.
+ */
+static void init_atoms(void){
+        if (ei_impl_atoms) return;
+        atoms_capacity = 32;
+        ei_impl_atoms = calloc(atoms_capacity, sizeof(ei_impl_atom_entry_t));
+        nb_atoms = 1;
+        grow_slots();
+        for (size_t i = 0; i < sizeof(predefined) / sizeof(predefined[0]); i++)
+                add_atom(predefined[i], hash_name(predefined[i]));
+}
+
+/**
+ * @brief Renvoie l'atome de name, créé s'il n'existe pas encore.
+ */
+ei_atom_t ei_impl_atom_intern(const char* name){
+        init_atoms();
+        uint32_t hash = hash_name(name);
+        uint32_t slot = find_slot(name, hash);
+        if (slots[slot] != ei_atom_none) return slots[slot];
+        return add_atom(name, hash);
+}
+
+/**
+ * @brief Renvoie l'atome de name, \ref ei_atom_none s'il n'a jamais été interné.
+ */
+ei_atom_t ei_impl_atom_find(const char* name){
+        init_atoms();
+        return slots[find_slot(name, hash_name(name))];
+}
+
+/**
+ * @brief Renvoie le nom interné de l'atome (valide jusqu'à \ref ei_impl_atom_free).
+ */
+const char* ei_impl_atom_name(ei_atom_t atom){
+        return atom != ei_atom_none && atom < nb_atoms ? ei_impl_atoms[atom].name : NULL;
+}
+
+/**
+ * @brief Associe une classe à l'atome de son nom (appelée par \ref ei_widgetclass_register).
+ */
+void ei_impl_atom_set_class(ei_atom_t atom, ei_widgetclass_t* wclass){
+        if (atom != ei_atom_none && atom < nb_atoms) ei_impl_atoms[atom].wclass = wclass;
+}
+
+/**
+ * @brief Libère la table des atomes (appelée par \ref ei_app_free).
+ */
+void ei_impl_atom_free(void){
+        for (ei_atom_t atom = 1; atom < nb_atoms; atom++) free(ei_impl_atoms[atom].name);
+        free(ei_impl_atoms);
+        free(slots);
+        ei_impl_atoms = NULL;
+        slots = NULL;
+        nb_atoms = atoms_capacity = slots_capacity = 0;
+}
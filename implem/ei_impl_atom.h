@@ -0,0 +1,84 @@
+/**
+ * @file	ei_impl_atom.h
+ *
+ * @brief 	Atomes : chaque nom de classe de widget ou de tag est interné une seule fois et représenté par un
+ *		petit entier. Deux noms égaux ont le même atome, les comparaisons de classes et de tags sont donc
+ *		des comparaisons d'entiers ou de pointeurs au lieu de strcmp. Les noms des classes prédéfinies
+ *		ont des atomes constants.
+ */
+
+#ifndef PROJETC_IG_EI_IMPL_ATOM_H
+#define PROJETC_IG_EI_IMPL_ATOM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ei_implementation.h"
+
+/**
+ * @brief Un atome : 0 pour aucun nom, sinon l'indice du nom dans la table.
+ */
+typedef uint32_t ei_atom_t;
+
+/**
+ * @brief Atomes des noms prédéfinis, réservés à la création de la table.
+ */
+enum {
+        ei_atom_none            = 0,
+        ei_atom_frame,
+        ei_atom_button,
+        ei_atom_toplevel,
+        ei_atom_entry,
+        ei_atom_all
+};
+
+/**
+ * @brief Une entrée de la table des atomes.
+ */
+typedef struct ei_impl_atom_entry_t {
+        char*                   name;           ///< copie du nom
+        uint32_t                hash;
+        ei_widgetclass_t*       wclass;         ///< classe enregistrée sous ce nom, NULL sinon
+} ei_impl_atom_entry_t;
+
+extern ei_impl_atom_entry_t* ei_impl_atoms;
+
+/**
+ * @brief Renvoie l'atome de name, créé s'il n'existe pas encore.
+ */
+ei_atom_t ei_impl_atom_intern(const char* name);
+
+/**
+ * @brief Renvoie l'atome de name, \ref ei_atom_none s'il n'a jamais été interné.
+ */
+ei_atom_t ei_impl_atom_find(const char* name);
+
+/**
+ * @brief Renvoie le nom interné de l'atome (valide jusqu'à \ref ei_impl_atom_free).
+ */
+const char* ei_impl_atom_name(ei_atom_t atom);
+
+/**
+ * @brief Associe une classe à l'atome de son nom (appelée par \ref ei_widgetclass_register).
+ */
+void ei_impl_atom_set_class(ei_atom_t atom, ei_widgetclass_t* wclass);
+
+/**
+ * @brief Renvoie la classe enregistrée sous le nom de l'atome, NULL s'il n'y en a pas.
+ */
+static inline ei_widgetclass_t* ei_impl_atom_class(ei_atom_t atom){
+        return atom != ei_atom_none && ei_impl_atoms ? ei_impl_atoms[atom].wclass : NULL;
+}
+
+/**
+ * @brief Dit si la classe de widget est celle enregistrée sous le nom de l'atome (comparaison de pointeurs).
+ */
+static inline bool ei_impl_widget_is(ei_widget_t widget, ei_atom_t class_atom){
+        return widget->wclass == ei_impl_atom_class(class_atom);
+}
+
+/**
+ * @brief Libère la table des atomes (appelée par \ref ei_app_free).
+ */
+void ei_impl_atom_free(void);
+
+#endif //PROJETC_IG_EI_IMPL_ATOM_H
@@ -3,37 +3,86 @@
 //
 
 #include "ei_impl_binds.h"
+#include "ei_impl_stats.h"
 
 // ============================ event
 
-//definit les binds
+//definit les binds (le plus récent en tête : c'est l'ordre d'appel des callbacks)
 ei_bind_t* binds = NULL;
 
 /**
- * @brief Fonction qui return la variable globale qui pointe sur les binds
- * @return variable globale pointant sur le dernier bind implémenté.
+ * Table de dispatch : pour chaque type d'évènement, les binds de ce type dans l'ordre de la liste. Elle est
+ * reconstruite au premier évènement qui suit un \ref ei_bind ou un \ref ei_unbind.
  */
-ei_bind_t* ei_get_head_binds(){
-        return binds;
+static ei_bind_t**      dispatch_table[ei_ev_last];
+static int              dispatch_size[ei_ev_last];
+static int              dispatch_capacity[ei_ev_last];
+static bool             dispatch_dirty  = true;
+
+//binds supprimés pendant un dispatch : libérés à la fin du dispatch (une copie de la table les contient encore)
+static int              dispatching     = 0;
+static ei_bind_t*       zombies         = NULL;
+
+
+/**
+ * @brief Reconstruit la table de dispatch à partir de la liste des binds.
+ */
+static void rebuild_dispatch_table(){
+        memset(dispatch_size, 0, sizeof(dispatch_size));
+        for (ei_bind_t* bind = binds; bind; bind = bind->next_bind){
+                int type = bind->eventtype;
+                if (type < 0 || type >= ei_ev_last) continue;
+                if (dispatch_size[type] == dispatch_capacity[type]){
+                        dispatch_capacity[type] = dispatch_capacity[type] ? 2 * dispatch_capacity[type] : 8;
+                        dispatch_table[type] = realloc(dispatch_table[type], dispatch_capacity[type] * sizeof(ei_bind_t*));
+                }
+                dispatch_table[type][dispatch_size[type]++] = bind;
+        }
+        dispatch_dirty = false;
 }
 
 /**
- * @brief Fonction retournant le premier bind correspondant au type d'evennement de event
- *
- * @param event l'évenement
- * @param current_bind le bind suivant de celui qui vient d'être executé
+ * @brief Appelle les callbacks des binds du type de event, du plus récent au plus ancien, jusqu'à ce qu'un
+ * callback renvoie true. Les clics et déplacements de la souris sont passés avec le widget sous le curseur
+ * (recalculé avant chaque callback, qui peut modifier la hiérarchie), les autres avec NULL.
+ * Seuls les binds du type de l'évènement sont parcourus. Les callbacks peuvent appeler \ref ei_bind et
+ * \ref ei_unbind : un bind ajouté pendant le dispatch n'est appelé qu'à partir de l'évènement suivant.
  *
- * @return le bind correspondant au type d'evennemebt de event.
+ * @param event l'évènement à traiter
  */
-ei_bind_t* ei_bind_from_event(ei_event_t* event, ei_bind_t* current_bind){
-        ei_bind_t* cur_bind = current_bind;
-        while (cur_bind){
-                if (event->type == cur_bind->eventtype){
-                        return cur_bind;
+void ei_impl_binds_dispatch(ei_event_t* event){
+        if (event->type < 0 || event->type >= ei_ev_last) return;
+        if (dispatch_dirty) rebuild_dispatch_table();
+        int size = dispatch_size[event->type];
+        if (size == 0) return;
+
+        //copie de la table : un callback peut la faire reconstruire
+        ei_bind_t* buffer[32];
+        ei_bind_t** called = size <= 32 ? buffer : malloc(size * sizeof(ei_bind_t*));
+        memcpy(called, dispatch_table[event->type], size * sizeof(ei_bind_t*));
+
+        bool mouse = event->type == ei_ev_mouse_buttondown || event->type == ei_ev_mouse_buttonup ||
+                     event->type == ei_ev_mouse_move;
+        dispatching++;
+        for (int i = 0; i < size; i++){
+                ei_bind_t* bind = called[i];
+                if (!bind->callback) continue; //supprimé par un callback précédent
+                ei_widget_t widget = mouse ? ei_widget_pick(&event->param.mouse.where) : NULL;
+                double start = ei_impl_stats_begin();
+                bool handled = (bind->callback)(widget, event, bind->user_param);
+                ei_impl_stats_end(ei_stats_callback, start);
+                if (handled) break;
+        }
+        dispatching--;
+
+        if (called != buffer) free(called);
+        if (dispatching == 0){
+                while (zombies){
+                        ei_bind_t* next = zombies->next_bind;
+                        free(zombies);
+                        zombies = next;
                 }
-                cur_bind = cur_bind->next_bind;
         }
-        return NULL;
 }
 
 /**
@@ -58,14 +107,28 @@ void ei_create_bind(ei_eventtype_t		eventtype,
                 new_bind->object.widget = widget;
                 new_bind->bind_isWidget = true;
         }else{
-                new_bind->object.tag=calloc(1,sizeof(ei_tag_t));
-                strcpy(new_bind->object.tag,tag);
+                //le tag est interné : sa comparaison dans ei_unbind est une comparaison d'atomes
+                new_bind->tag_atom = ei_impl_atom_intern(tag);
+                new_bind->object.tag = (ei_tag_t)ei_impl_atom_name(new_bind->tag_atom);
                 new_bind->bind_isWidget = false;
         }
         new_bind->eventtype = eventtype;
         new_bind->user_param= user_param;
+        dispatch_dirty = true;
 }
 
+/**
+ * @brief libère un bind retiré de la liste (plus tard s'il est dans la copie d'un dispatch en cours)
+ */
+static void release_bind(ei_bind_t* bind){
+        if (dispatching){
+                bind->callback = NULL;
+                bind->next_bind = zombies;
+                zombies = bind;
+        } else {
+                free(bind);
+        }
+}
 
 /**
  * @brief supprime un bind
@@ -80,28 +143,37 @@ void ei_delete_bind(ei_eventtype_t		eventtype,
                     ei_tag_t		tag,
                     ei_callback_t		callback,
                     void*			user_param){
-        ei_bind_t *current = NULL;
-        ei_bind_t *prec = binds;
-        if   (prec->eventtype==eventtype &&
-             ((prec->bind_isWidget && prec->object.widget == widget) || (!prec->bind_isWidget && strcmp(prec->object.tag, tag)==0)) &&
-             prec->callback == callback &&
-             prec->user_param == user_param){
-                binds = prec->next_bind;
-                free(prec);
-                return;
-        }
-        while (prec->next_bind){
-                current = prec->next_bind;
+        ei_atom_t tag_atom = widget || !tag ? ei_atom_none : ei_impl_atom_find(tag);
+        ei_bind_t** link = &binds;
+        while (*link){
+                ei_bind_t* current = *link;
                 if (current->eventtype==eventtype &&
-                    ((current->bind_isWidget && current->object.widget == widget) || (!current->bind_isWidget && strcmp(current->object.tag, tag)==0)) &&
+                    ((current->bind_isWidget && current->object.widget == widget) ||
+                     (!current->bind_isWidget && !widget && current->tag_atom == tag_atom)) &&
                     current->callback == callback &&
                     current->user_param == user_param){
-                        prec->next_bind=current->next_bind;
-                        if (!current->bind_isWidget) free(current->object.tag);
-                        free(current);
+                        *link = current->next_bind;
+                        release_bind(current);
+                        dispatch_dirty = true;
                         return;
                 }
-                prec = current;
+                link = &current->next_bind;
         }
 }
 
+/**
+ * @brief supprime tous les binds et la table de dispatch (appelée par \ref ei_app_free).
+ */
+void ei_impl_binds_free(){
+        while (binds){
+                ei_bind_t* next = binds->next_bind;
+                release_bind(binds);
+                binds = next;
+        }
+        for (int type = 0; type < ei_ev_last; type++){
+                free(dispatch_table[type]);
+                dispatch_table[type] = NULL;
+                dispatch_size[type] = dispatch_capacity[type] = 0;
+        }
+        dispatch_dirty = true;
+}
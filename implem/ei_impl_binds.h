@@ -6,6 +6,7 @@
 #define PROJETC_IG_EI_IMPL_BINDS_H
 
 #include "ei_implementation.h"
+#include "ei_impl_atom.h"
 
 //======================================== event
 
@@ -20,6 +21,7 @@ typedef struct ei_bind_t {
         ei_tag_t tag;
     } object;
     bool bind_isWidget; // 0 si object = tag, 1 si object = widget
+    ei_atom_t tag_atom; // atome du tag (object.tag est son nom interné), ei_atom_none pour un widget
     ei_eventtype_t eventtype;
     ei_callback_t callback;
     void* user_param;
@@ -27,20 +29,15 @@ typedef struct ei_bind_t {
 }ei_bind_t;
 
 /**
- * @brief Fonction qui return la variable globale qui pointe sur les binds
- * @return variable globale pointant sur le dernier bind implémenté.
- */
-ei_bind_t* ei_get_head_binds();
-
-/**
- * @brief Fonction retournant le premier bind correspondant au type d'evennement de event
- *
- * @param event l'évenement
- * @param current_bind le bind suivant de celui qui vient d'être executé
+ * @brief Appelle les callbacks des binds du type de event, du plus récent au plus ancien, jusqu'à ce qu'un
+ * callback renvoie true. Les clics et déplacements de la souris sont passés avec le widget sous le curseur
+ * (recalculé avant chaque callback, qui peut modifier la hiérarchie), les autres avec NULL.
+ * Seuls les binds du type de l'évènement sont parcourus. Les callbacks peuvent appeler \ref ei_bind et
+ * \ref ei_unbind : un bind ajouté pendant le dispatch n'est appelé qu'à partir de l'évènement suivant.
  *
- * @return le bind correspondant au type d'evennemebt de event.
+ * @param event l'évènement à traiter
  */
-ei_bind_t* ei_bind_from_event(ei_event_t* event, ei_bind_t* current_bind);
+void ei_impl_binds_dispatch(ei_event_t* event);
 
 /**
  * @brief creer un bind (et le link au autre binds de la variable globale
@@ -70,6 +67,9 @@ void ei_delete_bind(ei_eventtype_t		eventtype,
                     ei_callback_t		callback,
                     void*			user_param);
 
-
+/**
+ * @brief supprime tous les binds et la table de dispatch (appelée par \ref ei_app_free).
+ */
+void ei_impl_binds_free();
 
 #endif //PROJETC_IG_EI_IMPL_BINDS_H
@@ -0,0 +1,371 @@
+/**
+ * @file	ei_impl_blend.c
+ *
+ * @brief 	Implémentation des noyaux de mélange alpha et de remplissage : une version scalaire
+ *		portable, et des versions SSE2 / AVX2 choisies à l'exécution sur les processeurs x86
+ *		qui les supportent.
+ *
+ *		Tous les noyaux calculent exactement (dst * (255 - a) + src * a) / 255 par canal
+ *		(division entière), puis mettent le canal alpha du résultat à opaque.
+ */
+
+#include <string.h>
+#include "ei_impl_blend.h"
+#include "ei_implementation.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define EI_BLEND_X86 1
+#include <immintrin.h>
+#else
+#define EI_BLEND_X86 0
+#endif
+
+/**
+ * @brief Noyau scalaire : les canaux sont traités deux par deux (octets 0 et 2, puis 1 et 3)
+ * dans des mots de 16 bits d'un entier 32 bits. La division par 255 est remplacée par
+ * (x + 1 + (x >> 8)) >> 8, exacte pour x dans [0, 255*255].
+ */
+static void blend_row_scalar(uint32_t* dst, const uint32_t* src, int n, int alpha_shift){
+        uint32_t opaque = (uint32_t)0xFF << alpha_shift;
+        for (int i = 0; i < n; i++){
+                uint32_t s = src[i];
+                uint32_t a = (s >> alpha_shift) & 0xFF;
+                if (a == 0xFF){
+                        dst[i] = s | opaque;
+                        continue;
+                }
+                uint32_t d = dst[i];
+                if (a == 0){
+                        dst[i] = d | opaque;
+                        continue;
+                }
+                uint32_t ia = 255 - a;
+                uint32_t rb = (d & 0x00FF00FF) * ia + (s & 0x00FF00FF) * a;
+                uint32_t ga = ((d >> 8) & 0x00FF00FF) * ia + ((s >> 8) & 0x00FF00FF) * a;
+                rb = ((rb + 0x00010001 + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+                ga = ((ga + 0x00010001 + ((ga >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+                dst[i] = rb | (ga << 8) | opaque;
+        }
+}
+
+
+/**
+ * @brief Remplissage scalaire d'une ligne.
+ */
+static void fill_row_scalar(uint32_t* dst, int n, uint32_t pixel){
+        for (int i = 0; i < n; i++)
+                dst[i] = pixel;
+}
+
+
+#if EI_BLEND_X86
+
+/**
+ * @brief Noyau SSE2 : 4 pixels par itération, les canaux sont élargis à 16 bits.
+ */
+__attribute__((target("sse2")))
+static void blend_row_sse2(uint32_t* dst, const uint32_t* src, int n, int alpha_shift){
+        const __m128i zero      = _mm_setzero_si128();
+        const __m128i full      = _mm_set1_epi16(255);
+        const __m128i one       = _mm_set1_epi16(1);
+        const __m128i low_byte  = _mm_set1_epi32(0xFF);
+        const __m128i opaque    = _mm_set1_epi32((int)((uint32_t)0xFF << alpha_shift));
+        const __m128i shift     = _mm_cvtsi32_si128(alpha_shift);
+        int i = 0;
+        for (; i + 4 <= n; i += 4){
+                __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+                __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+
+                // on replique l'alpha de chaque pixel sur ses 4 octets
+                __m128i a = _mm_and_si128(_mm_srl_epi32(s, shift), low_byte);
+                a = _mm_or_si128(a, _mm_slli_epi32(a, 8));
+                a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+
+                __m128i a_lo = _mm_unpacklo_epi8(a, zero);
+                __m128i a_hi = _mm_unpackhi_epi8(a, zero);
+                __m128i x_lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), a_lo),
+                                             _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(full, a_lo)));
+                __m128i x_hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), a_hi),
+                                             _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(full, a_hi)));
+                x_lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x_lo, one), _mm_srli_epi16(x_lo, 8)), 8);
+                x_hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x_hi, one), _mm_srli_epi16(x_hi, 8)), 8);
+
+                _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(_mm_packus_epi16(x_lo, x_hi), opaque));
+        }
+        blend_row_scalar(dst + i, src + i, n - i, alpha_shift);
+}
+
+
+/**
+ * @brief Noyau AVX2 : 8 pixels par itération. Les unpack / pack travaillent par demi-registre de
+ * 128 bits, l'ordre des pixels est donc conservé.
+ */
+__attribute__((target("avx2")))
+static void blend_row_avx2(uint32_t* dst, const uint32_t* src, int n, int alpha_shift){
+        const __m256i zero      = _mm256_setzero_si256();
+        const __m256i full      = _mm256_set1_epi16(255);
+        const __m256i one       = _mm256_set1_epi16(1);
+        const __m256i low_byte  = _mm256_set1_epi32(0xFF);
+        const __m256i opaque    = _mm256_set1_epi32((int)((uint32_t)0xFF << alpha_shift));
+        const __m128i shift     = _mm_cvtsi32_si128(alpha_shift);
+        int i = 0;
+        for (; i + 8 <= n; i += 8){
+                __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+                __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+
+                __m256i a = _mm256_and_si256(_mm256_srl_epi32(s, shift), low_byte);
+                a = _mm256_or_si256(a, _mm256_slli_epi32(a, 8));
+                a = _mm256_or_si256(a, _mm256_slli_epi32(a, 16));
+
+                __m256i a_lo = _mm256_unpacklo_epi8(a, zero);
+                __m256i a_hi = _mm256_unpackhi_epi8(a, zero);
+                __m256i x_lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), a_lo),
+                                                _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_sub_epi16(full, a_lo)));
+                __m256i x_hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), a_hi),
+                                                _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_sub_epi16(full, a_hi)));
+                x_lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x_lo, one), _mm256_srli_epi16(x_lo, 8)), 8);
+                x_hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x_hi, one), _mm256_srli_epi16(x_hi, 8)), 8);
+
+                _mm256_storeu_si256((__m256i*)(dst + i), _mm256_or_si256(_mm256_packus_epi16(x_lo, x_hi), opaque));
+        }
+        blend_row_sse2(dst + i, src + i, n - i, alpha_shift);
+}
+
+
+/**
+ * @brief Remplissage SSE2 d'une ligne : 8 pixels par itération.
+ */
+__attribute__((target("sse2")))
+static void fill_row_sse2(uint32_t* dst, int n, uint32_t pixel){
+        const __m128i v = _mm_set1_epi32((int)pixel);
+        int i = 0;
+        for (; i + 8 <= n; i += 8){
+                _mm_storeu_si128((__m128i*)(dst + i), v);
+                _mm_storeu_si128((__m128i*)(dst + i + 4), v);
+        }
+        fill_row_scalar(dst + i, n - i, pixel);
+}
+
+
+/**
+ * @brief Remplissage AVX2 d'une ligne : 16 pixels par itération.
+ */
+__attribute__((target("avx2")))
+static void fill_row_avx2(uint32_t* dst, int n, uint32_t pixel){
+        const __m256i v = _mm256_set1_epi32((int)pixel);
+        int i = 0;
+        for (; i + 16 <= n; i += 16){
+                _mm256_storeu_si256((__m256i*)(dst + i), v);
+                _mm256_storeu_si256((__m256i*)(dst + i + 8), v);
+        }
+        fill_row_sse2(dst + i, n - i, pixel);
+}
+
+#endif
+
+
+/**
+ * \brief	Converts the red, green, blue and alpha components of a color into a 32 bits integer
+ * 		than can be written directly in the memory returned by \ref hw_surface_get_buffer.
+ * 		The surface parameter provides the channel order.
+ *
+ * @param	surface		The surface where to store this pixel, provides the channels order.
+ * @param	color		The color to convert.
+ *
+ * @return 			The 32 bit integer corresponding to the color. The alpha component
+ *				of the color is ignored in the case of surfaces that don't have an
+ *				alpha channel.
+ */
+uint32_t	ei_impl_map_rgba(ei_surface_t surface, ei_color_t color){
+        int ir, ig, ib, ia;
+        hw_surface_get_channel_indices(surface, &ir, &ig, &ib, &ia);
+        uint32_t pixel = ((uint32_t)color.red << (8 * ir)) |
+                         ((uint32_t)color.green << (8 * ig)) |
+                         ((uint32_t)color.blue << (8 * ib));
+        if (ia >= 0) pixel |= (uint32_t)color.alpha << (8 * ia);
+        return pixel;
+}
+
+
+//noyaux choisis au premier appel (voir select_kernels)
+static ei_impl_blend_row_t blend_row = NULL;
+static void (*fill_row)(uint32_t* dst, int n, uint32_t pixel) = NULL;
+
+/**
+ * @brief Choisit les noyaux les plus rapides supportés par le processeur.
+ */
+static void select_kernels(void){
+#if EI_BLEND_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")){
+                blend_row = blend_row_avx2;
+                fill_row  = fill_row_avx2;
+                return;
+        }
+        if (__builtin_cpu_supports("sse2")){
+                blend_row = blend_row_sse2;
+                fill_row  = fill_row_sse2;
+                return;
+        }
+#endif
+        blend_row = blend_row_scalar;
+        fill_row  = fill_row_scalar;
+}
+
+/**
+ * @brief Renvoie le noyau de mélange le plus rapide supporté par le processeur (AVX2, SSE2 ou
+ * scalaire). Le choix est fait une seule fois, au premier appel.
+ *
+ * @return le noyau de mélange d'une ligne.
+ */
+ei_impl_blend_row_t ei_impl_blend_row_kernel(void){
+        if (!blend_row) select_kernels();
+        return blend_row;
+}
+
+
+/**
+ * @brief Copie ou mélange un bloc de pixels déjà clippé : aucune vérification de bornes n'est faite.
+ *
+ * @param dst, dst_stride       premier pixel du bloc destination et largeur (en pixels) d'une ligne
+ * @param src, src_stride       premier pixel du bloc source et largeur (en pixels) d'une ligne
+ * @param width, height         taille du bloc
+ * @param alpha_shift           décalage du canal alpha de la source, négatif si la source n'a pas d'alpha
+ * @param alpha                 si false, les lignes sont copiées telles quelles (alpha compris).
+ */
+void ei_impl_blend_rows(uint32_t*       dst,
+                        int             dst_stride,
+                        const uint32_t* src,
+                        int             src_stride,
+                        int             width,
+                        int             height,
+                        int             alpha_shift,
+                        bool            alpha){
+        if (width <= 0 || height <= 0) return;
+
+        //sans alpha (ou si la source n'en a pas) c'est une simple copie ligne par ligne
+        //(de bas en haut si la destination recouvre la source plus loin dans la même surface)
+        if (!alpha || alpha_shift < 0){
+                if (dst > src){
+                        for (int y = height - 1; y >= 0; y--)
+                                memmove(dst + (size_t)y * dst_stride, src + (size_t)y * src_stride, (size_t)width * sizeof(uint32_t));
+                }else{
+                        for (int y = 0; y < height; y++)
+                                memmove(dst + (size_t)y * dst_stride, src + (size_t)y * src_stride, (size_t)width * sizeof(uint32_t));
+                }
+                return;
+        }
+
+        ei_impl_blend_row_t row = ei_impl_blend_row_kernel();
+        for (int y = 0; y < height; y++)
+                row(dst + (size_t)y * dst_stride, src + (size_t)y * src_stride, width, alpha_shift);
+}
+
+
+/**
+ * @brief Remplit un bloc de pixels déjà clippé avec une valeur de pixel opaque (déjà convertie par
+ * \ref ei_impl_map_rgba), par écritures vectorielles.
+ *
+ * @param dst, dst_stride       premier pixel du bloc et largeur (en pixels) d'une ligne de la surface
+ * @param width, height         taille du bloc
+ * @param pixel                 la valeur écrite dans chaque pixel
+ */
+void ei_impl_fill_rows(uint32_t*        dst,
+                       int              dst_stride,
+                       int              width,
+                       int              height,
+                       uint32_t         pixel){
+        if (width <= 0 || height <= 0) return;
+        if (!fill_row) select_kernels();
+
+        //si le bloc couvre des lignes entières, on le remplit comme une seule ligne
+        if (width == dst_stride){
+                fill_row(dst, width * height, pixel);
+                return;
+        }
+        for (int y = 0; y < height; y++)
+                fill_row(dst + (size_t)y * dst_stride, width, pixel);
+}
+
+
+/**
+ * @brief Mélange une couleur constante (transparente) sur un bloc de pixels déjà clippé.
+ *
+ * @param dst, dst_stride       premier pixel du bloc et largeur (en pixels) d'une ligne de la surface
+ * @param width, height         taille du bloc
+ * @param pixel                 la couleur, convertie par \ref ei_impl_map_rgba
+ * @param alpha                 la transparence de la couleur
+ * @param opaque                masque du canal alpha de la surface (0 si elle n'en a pas), forcé à 0xFF
+ */
+void ei_impl_blend_fill_rows(uint32_t*  dst,
+                             int        dst_stride,
+                             int        width,
+                             int        height,
+                             uint32_t   pixel,
+                             uint8_t    alpha,
+                             uint32_t   opaque){
+        if (width <= 0 || height <= 0 || alpha == 0) return;
+
+        //la contribution de la couleur (couleur * alpha) est la même pour tous les pixels
+        uint32_t ia = 255 - alpha;
+        uint32_t rb_color = (pixel & 0x00FF00FF) * alpha;
+        uint32_t ga_color = ((pixel >> 8) & 0x00FF00FF) * alpha;
+        for (int y = 0; y < height; y++){
+                uint32_t* row = dst + (size_t)y * dst_stride;
+                for (int i = 0; i < width; i++){
+                        uint32_t d = row[i];
+                        uint32_t rb = (d & 0x00FF00FF) * ia + rb_color;
+                        uint32_t ga = ((d >> 8) & 0x00FF00FF) * ia + ga_color;
+                        rb = ((rb + 0x00010001 + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+                        ga = ((ga + 0x00010001 + ((ga >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+                        row[i] = rb | (ga << 8) | opaque;
+                }
+        }
+}
+
+
+/**
+ * @brief Mélange une couleur constante sur un bloc de pixels déjà clippé, avec une couverture par pixel
+ * (masque 8 bits, par exemple un glyphe de \ref ei_impl_text_draw).
+ *
+ * @param dst, dst_stride       premier pixel du bloc et largeur (en pixels) d'une ligne de la surface
+ * @param mask, mask_stride     première couverture du bloc et largeur (en octets) d'une ligne du masque
+ * @param width, height         taille du bloc
+ * @param pixel                 la couleur, convertie par \ref ei_impl_map_rgba
+ * @param opaque                masque du canal alpha de la surface (0 si elle n'en a pas), forcé à 0xFF
+ */
+void ei_impl_blend_mask_rows(uint32_t*          dst,
+                             int                dst_stride,
+                             const uint8_t*     mask,
+                             int                mask_stride,
+                             int                width,
+                             int                height,
+                             uint32_t           pixel,
+                             uint32_t           opaque){
+        if (width <= 0 || height <= 0) return;
+
+        uint32_t rb_pixel = pixel & 0x00FF00FF;
+        uint32_t ga_pixel = (pixel >> 8) & 0x00FF00FF;
+        for (int y = 0; y < height; y++){
+                uint32_t* row = dst + (size_t)y * dst_stride;
+                const uint8_t* coverage = mask + (size_t)y * mask_stride;
+                for (int i = 0; i < width; i++){
+                        uint32_t a = coverage[i];
+                        if (a == 0){
+                                row[i] |= opaque;
+                                continue;
+                        }
+                        if (a == 0xFF){
+                                row[i] = pixel | opaque;
+                                continue;
+                        }
+                        uint32_t d = row[i];
+                        uint32_t ia = 255 - a;
+                        uint32_t rb = (d & 0x00FF00FF) * ia + rb_pixel * a;
+                        uint32_t ga = ((d >> 8) & 0x00FF00FF) * ia + ga_pixel * a;
+                        rb = ((rb + 0x00010001 + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+                        ga = ((ga + 0x00010001 + ((ga >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+                        row[i] = rb | (ga << 8) | opaque;
+                }
+        }
+}
@@ -0,0 +1,101 @@
+/**
+ * @file	ei_impl_blend.h
+ *
+ * @brief 	Noyaux de copie, de remplissage et de mélange alpha par ligne, utilisés par
+ *		\ref ei_copy_surface et \ref ei_fill.
+ *
+ */
+
+#ifndef PROJETC_IG_EI_IMPL_BLEND_H
+#define PROJETC_IG_EI_IMPL_BLEND_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Type d'un noyau de mélange d'une ligne de pixels.
+ *
+ * @param dst           premier pixel de la ligne destination
+ * @param src           premier pixel de la ligne source
+ * @param n             nombre de pixels de la ligne
+ * @param alpha_shift   décalage (en bits) du canal alpha dans un pixel source (8 * indice du canal)
+ */
+typedef void (*ei_impl_blend_row_t)(uint32_t* dst, const uint32_t* src, int n, int alpha_shift);
+
+/**
+ * @brief Renvoie le noyau de mélange le plus rapide supporté par le processeur (AVX2, SSE2 ou
+ * scalaire). Le choix est fait une seule fois, au premier appel.
+ *
+ * @return le noyau de mélange d'une ligne.
+ */
+ei_impl_blend_row_t ei_impl_blend_row_kernel(void);
+
+/**
+ * @brief Copie ou mélange un bloc de pixels déjà clippé : aucune vérification de bornes n'est faite.
+ *
+ * @param dst, dst_stride       premier pixel du bloc destination et largeur (en pixels) d'une ligne
+ * @param src, src_stride       premier pixel du bloc source et largeur (en pixels) d'une ligne
+ * @param width, height         taille du bloc
+ * @param alpha_shift           décalage du canal alpha de la source, négatif si la source n'a pas d'alpha
+ * @param alpha                 si false, les lignes sont copiées telles quelles (alpha compris).
+ */
+void ei_impl_blend_rows(uint32_t*       dst,
+                        int             dst_stride,
+                        const uint32_t* src,
+                        int             src_stride,
+                        int             width,
+                        int             height,
+                        int             alpha_shift,
+                        bool            alpha);
+
+/**
+ * @brief Remplit un bloc de pixels déjà clippé avec une valeur de pixel opaque (déjà convertie par
+ * \ref ei_impl_map_rgba), par écritures vectorielles.
+ *
+ * @param dst, dst_stride       premier pixel du bloc et largeur (en pixels) d'une ligne de la surface
+ * @param width, height         taille du bloc
+ * @param pixel                 la valeur écrite dans chaque pixel
+ */
+void ei_impl_fill_rows(uint32_t*        dst,
+                       int              dst_stride,
+                       int              width,
+                       int              height,
+                       uint32_t         pixel);
+
+/**
+ * @brief Mélange une couleur constante (transparente) sur un bloc de pixels déjà clippé.
+ *
+ * @param dst, dst_stride       premier pixel du bloc et largeur (en pixels) d'une ligne de la surface
+ * @param width, height         taille du bloc
+ * @param pixel                 la couleur, convertie par \ref ei_impl_map_rgba
+ * @param alpha                 la transparence de la couleur
+ * @param opaque                masque du canal alpha de la surface (0 si elle n'en a pas), forcé à 0xFF
+ */
+void ei_impl_blend_fill_rows(uint32_t*  dst,
+                             int        dst_stride,
+                             int        width,
+                             int        height,
+                             uint32_t   pixel,
+                             uint8_t    alpha,
+                             uint32_t   opaque);
+
+/**
+ * @brief Mélange une couleur constante sur un bloc de pixels déjà clippé, avec une couverture par pixel
+ * (masque 8 bits, par exemple un glyphe de \ref ei_impl_text_draw).
+ *
+ * @param dst, dst_stride       premier pixel du bloc et largeur (en pixels) d'une ligne de la surface
+ * @param mask, mask_stride     première couverture du bloc et largeur (en octets) d'une ligne du masque
+ * @param width, height         taille du bloc
+ * @param pixel                 la couleur, convertie par \ref ei_impl_map_rgba
+ * @param opaque                masque du canal alpha de la surface (0 si elle n'en a pas), forcé à 0xFF
+ */
+void ei_impl_blend_mask_rows(uint32_t*          dst,
+                             int                dst_stride,
+                             const uint8_t*     mask,
+                             int                mask_stride,
+                             int                width,
+                             int                height,
+                             uint32_t           pixel,
+                             uint32_t           opaque);
+
+#endif //PROJETC_IG_EI_IMPL_BLEND_H
@@ -0,0 +1,152 @@
+/**
+ * @file	ei_impl_font.c
+ *
+ * @brief 	Registre des polices partagées, en liste chaînée (il y en a peu) : la police trouvée est remise
+ *		en tête, les polices des dessins répétés (titre des toplevels) sont donc trouvées au premier essai.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ei_impl_font.h"
+#include "ei_impl_text.h"
+#include "hw_interface.h"
+
+
+/**
+ * @brief Une police du registre.
+ */
+typedef struct ei_impl_font_entry_t {
+        char*                           filename;
+        ei_fontstyle_t                  style;
+        int                             size;
+        ei_font_t                       font;
+        int                             references;
+        struct ei_impl_font_entry_t*    next;
+} ei_impl_font_entry_t;
+
+static ei_impl_font_entry_t*    fonts           = NULL;
+static int                      font_hits       = 0;
+static int                      font_misses     = 0;
+
+
+/*
+ * Cherche la police (filename, style, size) ; la crée si create est vrai. L'entrée trouvée passe en tête.
+ */
+static ei_impl_font_entry_t* find_font(ei_const_string_t filename, ei_fontstyle_t style, int size, bool create){
+        ei_impl_font_entry_t* previous = NULL;
+        for (ei_impl_font_entry_t* entry = fonts; entry; previous = entry, entry = entry->next){
+                if (entry->size != size || entry->style != style || strcmp(entry->filename, filename) != 0)
+                        continue;
+                if (previous){
+                        previous->next = entry->next;
+                        entry->next = fonts;
+                        fonts = entry;
+                }
+                font_hits++;
+                return entry;
+        }
+        if (!create) return NULL;
+
+        ei_font_t font = hw_text_font_create(filename, style, size);
+        font_misses++;
+        if (!font) return NULL;
+
+        ei_impl_font_entry_t* entry = calloc(1, sizeof(ei_impl_font_entry_t));
+        entry->filename = strdup(filename);
+        entry->style = style;
+        entry->size = size;
+        entry->font = font;
+        entry->next = fonts;
+        fonts = entry;
+        return entry;
+}
+
+static void close_font(ei_impl_font_entry_t* entry){
+        ei_impl_text_forget_font(entry->font);
+        hw_text_font_free(entry->font);
+        free(entry->filename);
+        free(entry);
+}
+
+/**
+ * @brief Renvoie la police partagée (filename, style, size), ouverte avec \ref hw_text_font_create au premier
+ * appel seulement, et incrémente son compteur de références.
+ *
+ * @param filename      fichier de la police (comparé par contenu)
+ * @param style         style de la police
+ * @param size          taille de la police
+ * @return la police, à rendre avec \ref ei_impl_font_release (ne jamais appeler \ref hw_text_font_free
+ *         dessus), NULL si elle n'a pas pu être ouverte.
+ */
+ei_font_t ei_impl_font_acquire(ei_const_string_t filename, ei_fontstyle_t style, int size){
+        ei_impl_font_entry_t* entry = find_font(filename, style, size, true);
+        if (!entry) return NULL;
+        entry->references++;
+        return entry->font;
+}
+
+/**
+ * @brief Rend une police obtenue par \ref ei_impl_font_acquire (décrémente son compteur de références).
+ *
+ * @param font          la police, peut être NULL
+ */
+void ei_impl_font_release(ei_font_t font){
+        if (!font) return;
+        for (ei_impl_font_entry_t* entry = fonts; entry; entry = entry->next){
+                if (entry->font == font){
+                        if (entry->references > 0) entry->references--;
+                        return;
+                }
+        }
+}
+
+/**
+ * @brief Ouvre la police (filename, style, size) à l'avance, sans la référencer : le premier dessin qui
+ * l'utilise ne paie pas l'ouverture du fichier.
+ */
+void ei_impl_font_preload(ei_const_string_t filename, ei_fontstyle_t style, int size){
+        if (find_font(filename, style, size, false)){
+                //un préchargement n'est pas un accès : on ne le compte pas comme un succès
+                font_hits--;
+                return;
+        }
+        find_font(filename, style, size, true);
+}
+
+/**
+ * @brief Ferme les polices qui ne sont plus référencées.
+ */
+void ei_impl_font_purge(void){
+        ei_impl_font_entry_t** link = &fonts;
+        while (*link){
+                ei_impl_font_entry_t* entry = *link;
+                if (entry->references == 0){
+                        *link = entry->next;
+                        close_font(entry);
+                } else {
+                        link = &entry->next;
+                }
+        }
+}
+
+/**
+ * @brief Ferme toutes les polices du registre (appelée par \ref ei_app_free).
+ */
+void ei_impl_font_free_all(void){
+        while (fonts){
+                ei_impl_font_entry_t* next = fonts->next;
+                close_font(fonts);
+                fonts = next;
+        }
+}
+
+/**
+ * @brief Statistiques du registre depuis le lancement.
+ *
+ * @param hits          si non NULL, reçoit le nombre d'appels à \ref ei_impl_font_acquire servis par le registre
+ * @param misses        si non NULL, reçoit le nombre de polices ouvertes (acquisitions et préchargements)
+ */
+void ei_impl_font_stats(int* hits, int* misses){
+        if (hits) *hits = font_hits;
+        if (misses) *misses = font_misses;
+}
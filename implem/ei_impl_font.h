@@ -0,0 +1,63 @@
+/**
+ * @file	ei_impl_font.h
+ *
+ * @brief 	Registre des polices : une police est ouverte une seule fois par triplet (fichier, style, taille),
+ *		puis partagée. Les poignées sont comptées par référence ; une police qui n'est plus référencée
+ *		reste ouverte (et son atlas de glyphes aussi) jusqu'à \ref ei_impl_font_purge ou
+ *		\ref ei_impl_font_free_all.
+ */
+
+#ifndef PROJETC_IG_EI_IMPL_FONT_H
+#define PROJETC_IG_EI_IMPL_FONT_H
+
+#include "ei_types.h"
+
+/**
+ * @brief Taille de la police du titre des toplevels, préchargée par \ref ei_app_create.
+ */
+#define EI_TOPLEVEL_TITLE_FONT_SIZE 18
+
+/**
+ * @brief Renvoie la police partagée (filename, style, size), ouverte avec \ref hw_text_font_create au premier
+ * appel seulement, et incrémente son compteur de références.
+ *
+ * @param filename      fichier de la police (comparé par contenu)
+ * @param style         style de la police
+ * @param size          taille de la police
+ * @return la police, à rendre avec \ref ei_impl_font_release (ne jamais appeler \ref hw_text_font_free
+ *         dessus), NULL si elle n'a pas pu être ouverte.
+ */
+ei_font_t ei_impl_font_acquire(ei_const_string_t filename, ei_fontstyle_t style, int size);
+
+/**
+ * @brief Rend une police obtenue par \ref ei_impl_font_acquire (décrémente son compteur de références).
+ *
+ * @param font          la police, peut être NULL
+ */
+void ei_impl_font_release(ei_font_t font);
+
+/**
+ * @brief Ouvre la police (filename, style, size) à l'avance, sans la référencer : le premier dessin qui
+ * l'utilise ne paie pas l'ouverture du fichier.
+ */
+void ei_impl_font_preload(ei_const_string_t filename, ei_fontstyle_t style, int size);
+
+/**
+ * @brief Ferme les polices qui ne sont plus référencées.
+ */
+void ei_impl_font_purge(void);
+
+/**
+ * @brief Ferme toutes les polices du registre (appelée par \ref ei_app_free).
+ */
+void ei_impl_font_free_all(void);
+
+/**
+ * @brief Statistiques du registre depuis le lancement.
+ *
+ * @param hits          si non NULL, reçoit le nombre d'appels à \ref ei_impl_font_acquire servis par le registre
+ * @param misses        si non NULL, reçoit le nombre de polices ouvertes (acquisitions et préchargements)
+ */
+void ei_impl_font_stats(int* hits, int* misses);
+
+#endif //PROJETC_IG_EI_IMPL_FONT_H
@@ -0,0 +1,116 @@
+/**
+ * @file	ei_impl_frame.c
+ *
+ * @brief 	Ordonnanceur d'images : fusion des déplacements de souris et réveil à la fin de la période.
+ */
+
+#include <stdlib.h>
+#include "ei_impl_frame.h"
+#include "ei_impl_binds.h"
+#include "ei_impl_timer.h"
+#include "hw_interface.h"
+
+static double           period          = EI_IMPL_FRAME_PERIOD_MS / 1000.0;
+static double           last_frame      = 0;
+static void*            wakeup          = NULL;  ///< réveil programmé, NULL s'il n'y en a pas
+static int              wakeup_tag;              ///< son adresse identifie les réveils de l'ordonnanceur
+static bool             move_held       = false;
+static ei_event_t       held_move;
+
+
+/**
+ * @brief Lit la période d'image (variable d'environnement EI_FRAME_MS). Appelée par \ref ei_app_run.
+ */
+void ei_impl_frame_init(void){
+        const char* env = getenv("EI_FRAME_MS");
+        int ms = env ? atoi(env) : EI_IMPL_FRAME_PERIOD_MS;
+        period = ms > 0 ? ms / 1000.0 : 0;
+        last_frame = 0;
+        move_held = false;
+}
+
+/**
+ * @brief Change la période d'image (0 : chaque évènement est traité et affiché seul).
+ *
+ * @param ms    la période, en millisecondes
+ */
+void ei_impl_frame_set_period(int ms){
+        period = ms > 0 ? ms / 1000.0 : 0;
+}
+
+/*
+ * Programme un réveil à la fin de la période courante (au plus un à la fois).
+ */
+static void schedule_wakeup(void){
+        if (wakeup) return;
+        int ms = (int)((last_frame + period - hw_now()) * 1000.0 + 0.999);
+        wakeup = hw_event_schedule_app(ms < 1 ? 1 : ms, &wakeup_tag);
+}
+
+static void flush_move(void){
+        if (!move_held) return;
+        move_held = false;
+        ei_impl_binds_dispatch(&held_move);
+}
+
+/**
+ * @brief Traite un évènement renvoyé par \ref hw_event_wait_next : un déplacement de souris est retenu
+ * jusqu'au prochain évènement d'un autre type ou jusqu'à la fin de la période, les autres évènements sont
+ * passés aux binds (après le déplacement retenu). Le réveil de l'ordonnanceur et celui des timers ne sont
+ * pas passés aux binds.
+ *
+ * @param event l'évènement
+ */
+void ei_impl_frame_event(ei_event_t* event){
+        if (ei_impl_timer_event(event)) return;
+        if (event->type == ei_ev_app && event->param.application.user_param == &wakeup_tag){
+                wakeup = NULL;
+                flush_move();
+                return;
+        }
+        if (event->type == ei_ev_mouse_move && period > 0){
+                //un seul picking pour toute une rafale de déplacements : le dernier remplace les précédents
+                held_move = *event;
+                move_held = true;
+                schedule_wakeup();
+                return;
+        }
+        flush_move();
+        ei_impl_binds_dispatch(event);
+}
+
+/**
+ * @brief Dit si une image doit être produite maintenant. S'il y a du travail mais qu'une image a été
+ * affichée il y a moins d'une période, programme un réveil à la fin de la période et renvoie false.
+ *
+ * @param work  vrai si une passe de layout ou un dessin est en attente
+ */
+bool ei_impl_frame_due(bool work){
+        if (!work) return false;
+        if (hw_now() - last_frame >= period) return true;
+        schedule_wakeup();
+        return false;
+}
+
+/**
+ * @brief A appeler après avoir produit une image : début de la période suivante.
+ */
+void ei_impl_frame_presented(void){
+        last_frame = hw_now();
+}
+
+/**
+ * @brief Demande une image à la fin de la période courante, même sans évènement (animations en cours).
+ */
+void ei_impl_frame_request(void){
+        schedule_wakeup();
+}
+
+/**
+ * @brief Annule le réveil programmé (appelée par \ref ei_app_free).
+ */
+void ei_impl_frame_free(void){
+        if (wakeup) hw_event_cancel_app(wakeup);
+        wakeup = NULL;
+        move_held = false;
+}
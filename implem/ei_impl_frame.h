@@ -0,0 +1,67 @@
+/**
+ * @file	ei_impl_frame.h
+ *
+ * @brief 	Ordonnanceur d'images de la boucle principale. Les évènements sont traités dès qu'ils arrivent,
+ *		mais la passe de layout, le dessin et l'affichage sont faits au plus une fois par période
+ *		d'image : si une image a été affichée il y a moins d'une période, un évènement application
+ *		(\ref hw_event_schedule_app) réveille la boucle à la fin de la période. Les déplacements de
+ *		souris qui se suivent sont fusionnés : seul le dernier est pické et passé aux callbacks.
+ *
+ *		La période est de EI_IMPL_FRAME_PERIOD_MS millisecondes, ou la valeur de la variable
+ *		d'environnement EI_FRAME_MS ; avec 0, chaque évènement est traité et affiché seul.
+ */
+
+#ifndef PROJETC_IG_EI_IMPL_FRAME_H
+#define PROJETC_IG_EI_IMPL_FRAME_H
+
+#include <stdbool.h>
+#include "ei_event.h"
+
+#define EI_IMPL_FRAME_PERIOD_MS 16
+
+/**
+ * @brief Lit la période d'image (variable d'environnement EI_FRAME_MS). Appelée par \ref ei_app_run.
+ */
+void ei_impl_frame_init(void);
+
+/**
+ * @brief Change la période d'image (0 : chaque évènement est traité et affiché seul).
+ *
+ * @param ms    la période, en millisecondes
+ */
+void ei_impl_frame_set_period(int ms);
+
+/**
+ * @brief Traite un évènement renvoyé par \ref hw_event_wait_next : un déplacement de souris est retenu
+ * jusqu'au prochain évènement d'un autre type ou jusqu'à la fin de la période, les autres évènements sont
+ * passés aux binds (après le déplacement retenu). Le réveil de l'ordonnanceur et celui des timers ne sont
+ * pas passés aux binds.
+ *
+ * @param event l'évènement
+ */
+void ei_impl_frame_event(ei_event_t* event);
+
+/**
+ * @brief Dit si une image doit être produite maintenant. S'il y a du travail mais qu'une image a été
+ * affichée il y a moins d'une période, programme un réveil à la fin de la période et renvoie false.
+ *
+ * @param work  vrai si une passe de layout ou un dessin est en attente
+ */
+bool ei_impl_frame_due(bool work);
+
+/**
+ * @brief A appeler après avoir produit une image : début de la période suivante.
+ */
+void ei_impl_frame_presented(void);
+
+/**
+ * @brief Demande une image à la fin de la période courante, même sans évènement (animations en cours).
+ */
+void ei_impl_frame_request(void);
+
+/**
+ * @brief Annule le réveil programmé (appelée par \ref ei_app_free).
+ */
+void ei_impl_frame_free(void);
+
+#endif //PROJETC_IG_EI_IMPL_FRAME_H
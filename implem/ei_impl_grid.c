@@ -0,0 +1,309 @@
+/**
+ * @file	ei_impl_grid.c
+ *
+ * @brief 	Gestionnaire de géométrie "grid" : listes de cellules des pistes, calcul des tailles et des
+ *		positions des pistes, runfunc et releasefunc.
+ */
+
+#include <stdlib.h>
+#include "ei_impl_grid.h"
+#include "ei_impl_layout.h"
+#include "ei_geometrymanager.h"
+
+ei_impl_slab_t ei_impl_grid_slab = EI_IMPL_SLAB_INIT(sizeof(ei_impl_grid_cell_t));
+
+//les grilles des conteneurs (peu nombreuses : une par plateau ou formulaire)
+static ei_impl_grid_t* grids = NULL;
+
+
+static void list_push(ei_impl_grid_list_t* list, ei_impl_grid_cell_t* cell, int dim){
+        if (list->nb_cells == list->capacity){
+                list->capacity = list->capacity ? 2 * list->capacity : 8;
+                list->cells = realloc(list->cells, list->capacity * sizeof(ei_impl_grid_cell_t*));
+        }
+        cell->slot[dim] = list->nb_cells;
+        list->cells[list->nb_cells++] = cell;
+}
+
+/*
+ * Retire cell en temps constant : la dernière cellule de la liste prend sa place.
+ */
+static void list_remove(ei_impl_grid_list_t* list, ei_impl_grid_cell_t* cell, int dim){
+        ei_impl_grid_cell_t* last = list->cells[--list->nb_cells];
+        list->cells[cell->slot[dim]] = last;
+        last->slot[dim] = cell->slot[dim];
+}
+
+/**
+ * @brief Renvoie la grille de container, créée si create est vrai et qu'il n'en a pas (NULL sinon).
+ */
+ei_impl_grid_t* ei_impl_grid_of(ei_widget_t container, bool create){
+        for (ei_impl_grid_t* grid = grids; grid; grid = grid->next)
+                if (grid->container == container) return grid;
+        if (!create) return NULL;
+        ei_impl_grid_t* grid = calloc(1, sizeof(ei_impl_grid_t));
+        grid->container = container;
+        grid->dirty = true;
+        container->layout_flags |= ei_impl_layout_grid;
+        grid->next = grids;
+        grids = grid;
+        return grid;
+}
+
+/**
+ * @brief Renvoie la piste index de la dimension, en agrandissant la grille si besoin.
+ */
+ei_impl_grid_track_t* ei_impl_grid_track(ei_impl_grid_t* grid, int dim, int index){
+        if (index >= grid->nb_tracks[dim]){
+                grid->tracks[dim] = realloc(grid->tracks[dim], (index + 1) * sizeof(ei_impl_grid_track_t));
+                for (int t = grid->nb_tracks[dim]; t <= index; t++)
+                        grid->tracks[dim][t] = (ei_impl_grid_track_t){.dirty = true};
+                grid->nb_tracks[dim] = index + 1;
+                grid->dirty = true;
+        }
+        return &grid->tracks[dim][index];
+}
+
+/**
+ * @brief Ajoute une cellule à la grille (ses positions et spans sont déjà remplis).
+ */
+void ei_impl_grid_attach(ei_impl_grid_t* grid, ei_impl_grid_cell_t* cell){
+        cell->grid = grid;
+        cell->natural[0] = cell->widget->requested_size.width + 2 * cell->pad[0];
+        cell->natural[1] = cell->widget->requested_size.height + 2 * cell->pad[1];
+        for (int dim = 0; dim < 2; dim++){
+                ei_impl_grid_track(grid, dim, cell->pos[dim] + cell->span[dim] - 1);
+                if (cell->span[dim] == 1){
+                        ei_impl_grid_track_t* track = &grid->tracks[dim][cell->pos[dim]];
+                        list_push(&track->cells, cell, dim);
+                        track->dirty = true;
+                } else {
+                        list_push(&grid->spanning[dim], cell, dim);
+                }
+        }
+        grid->nb_cells++;
+        grid->dirty = true;
+}
+
+/**
+ * @brief Retire une cellule de la grille (avant de changer sa position ou de la libérer).
+ */
+void ei_impl_grid_detach(ei_impl_grid_cell_t* cell){
+        ei_impl_grid_t* grid = cell->grid;
+        for (int dim = 0; dim < 2; dim++){
+                if (cell->span[dim] == 1){
+                        ei_impl_grid_track_t* track = &grid->tracks[dim][cell->pos[dim]];
+                        list_remove(&track->cells, cell, dim);
+                        track->dirty = true;
+                } else {
+                        list_remove(&grid->spanning[dim], cell, dim);
+                }
+        }
+        grid->nb_cells--;
+        grid->dirty = true;
+}
+
+/**
+ * @brief Marque les tailles de la grille à recalculer à la prochaine passe de layout.
+ */
+void ei_impl_grid_invalidate(ei_impl_grid_t* grid){
+        grid->dirty = true;
+        ei_impl_layout_mark_container(grid->container);
+}
+
+/*
+ * container_alive est faux dans ei_impl_grid_free_all, après la destruction de tous les widgets.
+ */
+static void free_grid(ei_impl_grid_t* grid, bool container_alive){
+        if (container_alive) grid->container->layout_flags &= ~ei_impl_layout_grid;
+        ei_impl_grid_t** link = &grids;
+        while (*link != grid) link = &(*link)->next;
+        *link = grid->next;
+        for (int dim = 0; dim < 2; dim++){
+                for (int t = 0; t < grid->nb_tracks[dim]; t++) free(grid->tracks[dim][t].cells.cells);
+                free(grid->tracks[dim]);
+                free(grid->spanning[dim].cells);
+        }
+        free(grid);
+}
+
+/**
+ * @brief Libère les grilles qui restent (conteneurs configurés sans cellule, appelée par \ref ei_app_free).
+ */
+void ei_impl_grid_free_all(void){
+        while (grids) free_grid(grids, false);
+}
+
+/*
+ * Tailles et positions des pistes d'une dimension, en une passe sur les pistes et les cellules multi-pistes.
+ * Seules les pistes marquées relisent les tailles de leurs cellules. Renvoie vrai si une piste a changé.
+ */
+static bool update_dimension(ei_impl_grid_t* grid, int dim, int available){
+        ei_impl_grid_track_t* tracks = grid->tracks[dim];
+        int n = grid->nb_tracks[dim];
+
+        for (int t = 0; t < n; t++){
+                if (tracks[t].dirty){
+                        tracks[t].base = tracks[t].min_size;
+                        for (int c = 0; c < tracks[t].cells.nb_cells; c++)
+                                if (tracks[t].cells.cells[c]->natural[dim] > tracks[t].base)
+                                        tracks[t].base = tracks[t].cells.cells[c]->natural[dim];
+                        tracks[t].dirty = false;
+                }
+                tracks[t].size = tracks[t].base;
+        }
+
+        //une cellule multi-pistes trop grande agrandit ses pistes de la même quantité
+        for (int c = 0; c < grid->spanning[dim].nb_cells; c++){
+                ei_impl_grid_cell_t* cell = grid->spanning[dim].cells[c];
+                int first = cell->pos[dim], span = cell->span[dim];
+                int sum = 0;
+                for (int t = first; t < first + span; t++) sum += tracks[t].size;
+                int missing = cell->natural[dim] - sum;
+                for (int t = first; missing > 0 && t < first + span; t++)
+                        tracks[t].size += missing / span + (t - first < missing % span ? 1 : 0);
+        }
+
+        if (grid->uniform[dim]){
+                int largest = 0;
+                for (int t = 0; t < n; t++) if (tracks[t].size > largest) largest = tracks[t].size;
+                for (int t = 0; t < n; t++) tracks[t].size = largest;
+        }
+
+        //la place restante est partagée entre les pistes qui ont un poids
+        int total = 0;
+        float weights = 0;
+        int last_weighted = -1;
+        for (int t = 0; t < n; t++){
+                total += tracks[t].size;
+                if (tracks[t].weight > 0){
+                        weights += tracks[t].weight;
+                        last_weighted = t;
+                }
+        }
+        int extra = available - total;
+        if (extra > 0 && last_weighted >= 0){
+                int given = 0;
+                for (int t = 0; t < last_weighted; t++){
+                        if (tracks[t].weight <= 0) continue;
+                        int share = (int)(extra * tracks[t].weight / weights);
+                        tracks[t].size += share;
+                        given += share;
+                }
+                tracks[last_weighted].size += extra - given;
+        }
+
+        bool changed = false;
+        int offset = 0;
+        for (int t = 0; t < n; t++){
+                changed |= tracks[t].offset != offset || tracks[t].laid_size != tracks[t].size;
+                tracks[t].offset = offset;
+                tracks[t].laid_size = tracks[t].size;
+                offset += tracks[t].size;
+        }
+        return changed;
+}
+
+static ei_rect_t content_of(ei_widget_t container){
+        return container->content_rect ? *container->content_rect : container->screen_location;
+}
+
+/*
+ * Recalcule les pistes si la grille est marquée ou si le conteneur a changé de taille. Si une piste a changé,
+ * toutes les cellules sont marquées : la passe de layout les recalcule une fois chacune.
+ */
+static void update_grid(ei_impl_grid_t* grid){
+        ei_size_t available = content_of(grid->container).size;
+        if (available.width != grid->available.width || available.height != grid->available.height){
+                grid->available = available;
+                grid->dirty = true;
+        }
+        if (!grid->dirty) return;
+        bool changed = update_dimension(grid, 0, available.width);
+        changed |= update_dimension(grid, 1, available.height);
+        grid->dirty = false;
+        if (!changed) return;
+        ei_geometrymanager_t* manager = ei_geometrymanager_from_name("grid\0");
+        for (ei_widget_t child = grid->container->children_head; child; child = child->next_sibling)
+                if (child->geom_params && child->geom_params->manager == manager)
+                        ei_impl_layout_mark(child);
+}
+
+/**
+ * @brief Appelée par la passe de layout avant de descendre dans les enfants d'un conteneur qui a une grille :
+ * recalcule les pistes si besoin, et marque toutes les cellules si une piste a changé.
+ */
+void ei_impl_grid_prepare(ei_widget_t container){
+        ei_impl_grid_t* grid = ei_impl_grid_of(container, false);
+        if (grid) update_grid(grid);
+}
+
+/*
+ * Position de size dans area selon l'ancrage.
+ */
+static ei_point_t anchored(ei_rect_t area, ei_size_t size, ei_anchor_t anchor){
+        int free_x = area.size.width - size.width;
+        int free_y = area.size.height - size.height;
+        int dx = free_x / 2, dy = free_y / 2;
+        switch (anchor){
+                case ei_anc_northwest:  dx = 0;         dy = 0;         break;
+                case ei_anc_north:                      dy = 0;         break;
+                case ei_anc_northeast:  dx = free_x;    dy = 0;         break;
+                case ei_anc_west:       dx = 0;                         break;
+                case ei_anc_east:       dx = free_x;                    break;
+                case ei_anc_southwest:  dx = 0;         dy = free_y;    break;
+                case ei_anc_south:                      dy = free_y;    break;
+                case ei_anc_southeast:  dx = free_x;    dy = free_y;    break;
+                default:                                                break;
+        }
+        return (ei_point_t){area.top_left.x + dx, area.top_left.y + dy};
+}
+
+/**
+ * @brief   Fonction run geometrymanager de GRID, appelée par la passe de layout (\ref ei_impl_layout_run)
+ */
+void ei_impl_grid_runfunc(ei_widget_t widget){
+        ei_impl_grid_cell_t* cell = (ei_impl_grid_cell_t*)widget->geom_params;
+        ei_impl_grid_t* grid = cell->grid;
+
+        //taille demandée changée sans nouvel appel à ei_grid : seules ses pistes sont recalculées, mais les
+        //cellules déjà parcourues par cette passe ne seront replacées qu'à la suivante
+        if (cell->natural[0] != widget->requested_size.width + 2 * cell->pad[0] ||
+            cell->natural[1] != widget->requested_size.height + 2 * cell->pad[1]){
+                ei_impl_grid_detach(cell);
+                ei_impl_grid_attach(grid, cell);
+        }
+        update_grid(grid);
+
+        ei_rect_t content = content_of(grid->container);
+
+        ei_impl_grid_track_t* first_col = &grid->tracks[0][cell->pos[0]];
+        ei_impl_grid_track_t* last_col = &grid->tracks[0][cell->pos[0] + cell->span[0] - 1];
+        ei_impl_grid_track_t* first_row = &grid->tracks[1][cell->pos[1]];
+        ei_impl_grid_track_t* last_row = &grid->tracks[1][cell->pos[1] + cell->span[1] - 1];
+        ei_rect_t area = {
+                {content.top_left.x + first_col->offset + cell->pad[0], content.top_left.y + first_row->offset + cell->pad[1]},
+                {last_col->offset + last_col->size - first_col->offset - 2 * cell->pad[0],
+                 last_row->offset + last_row->size - first_row->offset - 2 * cell->pad[1]}};
+
+        ei_rect_t new_surface = area;
+        if (cell->anchor != ei_anc_none){
+                new_surface.size = widget->requested_size;
+                new_surface.top_left = anchored(area, widget->requested_size, cell->anchor);
+        }
+        ei_geometry_run_finalize(widget, &new_surface);
+}
+
+/**
+ * @brief Release function of grid
+ */
+void ei_impl_grid_releasefunc(ei_widget_t widget){
+        ei_impl_grid_cell_t* cell = (ei_impl_grid_cell_t*)widget->geom_params;
+        ei_impl_grid_t* grid = cell->grid;
+        ei_app_invalidate_rect(&widget->screen_location);
+        ei_impl_grid_detach(cell);
+        if (grid->nb_cells == 0) free_grid(grid, true);
+        else ei_impl_grid_invalidate(grid);
+        ei_impl_slab_free(&ei_impl_grid_slab, cell);
+        widget->geom_params=NULL;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file	ei_impl_grid.h
+ *
+ * @brief 	Gestionnaire de géométrie "grid". Chaque conteneur géré a une grille : deux tableaux de pistes
+ *		(colonnes et lignes), avec pour chaque piste la liste des cellules qui ne couvrent qu'elle, et
+ *		la liste des cellules qui couvrent plusieurs pistes. La taille naturelle d'une piste n'est
+ *		recalculée que si une de ses cellules a changé ; les tailles finales et les positions des
+ *		pistes sont recalculées en une passe linéaire par la passe de layout, juste avant qu'elle ne
+ *		descende dans les enfants du conteneur (\ref ei_impl_grid_prepare). Les cellules ne sont
+ *		toutes recalculées que si une piste a changé de taille ou de position.
+ */
+
+#ifndef PROJETC_IG_EI_IMPL_GRID_H
+#define PROJETC_IG_EI_IMPL_GRID_H
+
+#include "ei_implementation.h"
+#include "ei_grid.h"
+#include "ei_impl_slab.h"
+
+struct ei_impl_grid_t;
+
+/**
+ * @brief Structure definissant le geom_param de type grid. Les tableaux à deux cases sont indexés par la
+ * dimension : 0 pour les colonnes (x), 1 pour les lignes (y).
+ */
+typedef struct ei_impl_grid_cell_t {
+        ei_impl_geom_param_t    geom_param;
+        struct ei_impl_grid_t*  grid;
+        ei_widget_t             widget;
+        int                     pos[2];         ///< première colonne, première ligne
+        int                     span[2];
+        int                     pad[2];
+        ei_anchor_t             anchor;
+        int                     natural[2];     ///< taille demandée + padding, dernière valeur vue par la grille
+        int                     slot[2];        ///< indice dans la liste de sa piste (ou des cellules multi-pistes)
+} ei_impl_grid_cell_t;
+
+/**
+ * @brief Une liste de cellules, où chaque cellule connaît son indice (ei_impl_grid_cell_t::slot).
+ */
+typedef struct ei_impl_grid_list_t {
+        ei_impl_grid_cell_t**   cells;
+        int                     nb_cells;
+        int                     capacity;
+} ei_impl_grid_list_t;
+
+/**
+ * @brief Une ligne ou une colonne.
+ */
+typedef struct ei_impl_grid_track_t {
+        int                     min_size;
+        float                   weight;
+        int                     base;           ///< plus grande taille naturelle des cellules d'une seule piste
+        int                     size;           ///< taille finale
+        int                     offset;         ///< position depuis le bord du contenu du conteneur
+        int                     laid_size;      ///< taille au calcul précédent
+        bool                    dirty;          ///< base à recalculer
+        ei_impl_grid_list_t     cells;          ///< cellules qui ne couvrent que cette piste
+} ei_impl_grid_track_t;
+
+/**
+ * @brief La grille d'un conteneur.
+ */
+typedef struct ei_impl_grid_t {
+        ei_widget_t             container;
+        ei_impl_grid_track_t*   tracks[2];
+        int                     nb_tracks[2];
+        ei_impl_grid_list_t     spanning[2];    ///< cellules qui couvrent plusieurs pistes de la dimension
+        bool                    uniform[2];
+        int                     nb_cells;
+        ei_size_t               available;      ///< taille du contenu du conteneur au dernier calcul
+        bool                    dirty;          ///< tailles des pistes à recalculer
+        struct ei_impl_grid_t*  next;
+} ei_impl_grid_t;
+
+/**
+ * @brief   Slab des cellules du grid (allouées par \ref ei_grid, rendues par \ref ei_impl_grid_releasefunc)
+ */
+extern ei_impl_slab_t ei_impl_grid_slab;
+
+/**
+ * @brief Renvoie la grille de container, créée si create est vrai et qu'il n'en a pas (NULL sinon).
+ */
+ei_impl_grid_t* ei_impl_grid_of(ei_widget_t container, bool create);
+
+/**
+ * @brief Ajoute une cellule à la grille (ses positions et spans sont déjà remplis).
+ */
+void ei_impl_grid_attach(ei_impl_grid_t* grid, ei_impl_grid_cell_t* cell);
+
+/**
+ * @brief Retire une cellule de la grille (avant de changer sa position ou de la libérer).
+ */
+void ei_impl_grid_detach(ei_impl_grid_cell_t* cell);
+
+/**
+ * @brief Renvoie la piste index de la dimension, en agrandissant la grille si besoin.
+ */
+ei_impl_grid_track_t* ei_impl_grid_track(ei_impl_grid_t* grid, int dim, int index);
+
+/**
+ * @brief Marque les tailles de la grille à recalculer à la prochaine passe de layout.
+ */
+void ei_impl_grid_invalidate(ei_impl_grid_t* grid);
+
+/**
+ * @brief Appelée par la passe de layout avant de descendre dans les enfants d'un conteneur qui a une grille :
+ * recalcule les pistes si besoin, et marque toutes les cellules si une piste a changé.
+ */
+void ei_impl_grid_prepare(ei_widget_t container);
+
+/**
+ * @brief Libère les grilles qui restent (conteneurs configurés sans cellule, appelée par \ref ei_app_free).
+ */
+void ei_impl_grid_free_all(void);
+
+/**
+ * @brief   Fonction run geometrymanager de GRID, appelée par la passe de layout (\ref ei_impl_layout_run)
+ */
+void ei_impl_grid_runfunc(ei_widget_t widget);
+
+/**
+ * @brief Release function of grid
+ */
+void ei_impl_grid_releasefunc(ei_widget_t widget);
+
+#endif //PROJETC_IG_EI_IMPL_GRID_H
@@ -0,0 +1,97 @@
+/**
+ * @file	ei_impl_layout.c
+ *
+ * @brief 	Passe de calcul de géométrie. Un widget marqué a le drapeau \ref ei_impl_layout_dirty, et tous
+ *		ses ancêtres le drapeau \ref ei_impl_layout_children : la passe ne descend que dans les
+ *		branches qui contiennent un widget marqué. Pendant la passe, \ref ei_geometry_run_finalize
+ *		marque les enfants du widget qu'il vient de calculer : ils sont recalculés dans la même passe.
+ */
+
+#include "ei_impl_layout.h"
+#include "ei_application.h"
+#include "ei_impl_grid.h"
+
+static bool     pending         = false;
+static bool     in_pass         = false;
+
+
+/**
+ * @brief Marque la géométrie de widget à recalculer à la prochaine passe.
+ */
+void ei_impl_layout_mark(ei_widget_t widget){
+        if (!widget) return;
+        widget->layout_flags |= ei_impl_layout_dirty;
+        //on remonte jusqu'au premier ancêtre déjà marqué
+        for (ei_widget_t ancestor = widget->parent;
+             ancestor && !(ancestor->layout_flags & ei_impl_layout_children);
+             ancestor = ancestor->parent)
+                ancestor->layout_flags |= ei_impl_layout_children;
+        pending = true;
+}
+
+/**
+ * @brief Demande à la prochaine passe de descendre dans les enfants de widget, sans recalculer widget.
+ */
+void ei_impl_layout_mark_container(ei_widget_t widget){
+        for (ei_widget_t ancestor = widget;
+             ancestor && !(ancestor->layout_flags & ei_impl_layout_children);
+             ancestor = ancestor->parent)
+                ancestor->layout_flags |= ei_impl_layout_children;
+        pending = true;
+}
+
+/**
+ * @brief Marque la géométrie de tous les enfants de widget à recalculer (position ou taille de widget modifiée).
+ */
+void ei_impl_layout_mark_children(ei_widget_t widget){
+        for (ei_widget_t child = widget->children_head; child; child = child->next_sibling)
+                ei_impl_layout_mark(child);
+}
+
+/**
+ * @brief Dit si une passe est en attente.
+ */
+bool ei_impl_layout_pending(void){
+        return pending;
+}
+
+/*
+ * Recalcule widget s'il est marqué, puis ses descendants marqués. Le drapeau children est enlevé avant le
+ * parcours des enfants : une marque posée pendant le parcours remarque le chemin jusqu'à la racine, et un
+ * widget déjà parcouru qui serait remarqué est recalculé à la passe suivante au lieu d'être oublié.
+ */
+static void layout(ei_widget_t widget){
+        if (widget->layout_flags & ei_impl_layout_dirty){
+                widget->layout_flags &= ~ei_impl_layout_dirty;
+                if (widget->geom_params && widget->geom_params->manager){
+                        (widget->geom_params->manager->runfunc)(widget);
+                        //un widget qui apparaît sans bouger n'est pas abîmé par ei_geometry_run_finalize
+                        if (widget->layout_flags & ei_impl_layout_new)
+                                ei_app_invalidate_rect(&widget->screen_location);
+                }
+                widget->layout_flags &= ~ei_impl_layout_new;
+        }
+        if (widget->layout_flags & ei_impl_layout_children){
+                //une grille calcule ses pistes avant ses cellules (et les marque si une piste a bougé)
+                if (widget->layout_flags & ei_impl_layout_grid) ei_impl_grid_prepare(widget);
+                widget->layout_flags &= ~ei_impl_layout_children;
+                for (ei_widget_t child = widget->children_head; child; child = child->next_sibling)
+                        if (child->layout_flags & (ei_impl_layout_dirty | ei_impl_layout_children))
+                                layout(child);
+        }
+}
+
+/**
+ * @brief Recalcule, de la racine vers les feuilles, la géométrie des widgets marqués. Sans effet si rien
+ * n'est marqué. Appelée par \ref ei_app_run avant chaque dessin et par le picking géométrique.
+ */
+void ei_impl_layout_run(void){
+        if (!pending || in_pass) return;
+        pending = false;
+        in_pass = true;
+        ei_widget_t root = ei_app_root_widget();
+        layout(root);
+        in_pass = false;
+        //les marques posées pendant la passe ont remarqué le chemin jusqu'à la racine
+        pending = (root->layout_flags & (ei_impl_layout_dirty | ei_impl_layout_children)) != 0;
+}
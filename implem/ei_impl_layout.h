@@ -0,0 +1,52 @@
+/**
+ * @file	ei_impl_layout.h
+ *
+ * @brief 	Calcul différé de la géométrie. \ref ei_place et les callbacks qui déplacent un widget ne lancent
+ *		plus les gestionnaires de géométrie : ils marquent les widgets à recalculer, et une seule passe
+ *		de haut en bas (\ref ei_impl_layout_run) recalcule les widgets marqués juste avant le dessin.
+ *		Chaque widget est donc recalculé au plus une fois par image, et seuls les widgets dont la
+ *		géométrie a vraiment changé abîment l'écran.
+ */
+
+#ifndef PROJETC_IG_EI_IMPL_LAYOUT_H
+#define PROJETC_IG_EI_IMPL_LAYOUT_H
+
+#include "ei_implementation.h"
+
+/**
+ * @brief Drapeaux de \ref ei_impl_widget_t::layout_flags.
+ */
+enum {
+        ei_impl_layout_dirty    = 1 << 0,       ///< la géométrie du widget est à recalculer
+        ei_impl_layout_children = 1 << 1,       ///< un descendant est marqué
+        ei_impl_layout_new      = 1 << 2,       ///< le widget vient d'être placé : à dessiner même s'il n'a pas bougé
+        ei_impl_layout_grid     = 1 << 3        ///< le widget a une grille (voir ei_impl_grid.h)
+};
+
+/**
+ * @brief Marque la géométrie de widget à recalculer à la prochaine passe.
+ */
+void ei_impl_layout_mark(ei_widget_t widget);
+
+/**
+ * @brief Demande à la prochaine passe de descendre dans les enfants de widget, sans recalculer widget.
+ */
+void ei_impl_layout_mark_container(ei_widget_t widget);
+
+/**
+ * @brief Marque la géométrie de tous les enfants de widget à recalculer (position ou taille de widget modifiée).
+ */
+void ei_impl_layout_mark_children(ei_widget_t widget);
+
+/**
+ * @brief Dit si une passe est en attente.
+ */
+bool ei_impl_layout_pending(void);
+
+/**
+ * @brief Recalcule, de la racine vers les feuilles, la géométrie des widgets marqués. Sans effet si rien
+ * n'est marqué. Appelée par \ref ei_app_run avant chaque dessin et par le picking géométrique.
+ */
+void ei_impl_layout_run(void);
+
+#endif //PROJETC_IG_EI_IMPL_LAYOUT_H
@@ -0,0 +1,198 @@
+/**
+ * @file	ei_impl_pick.c
+ *
+ * @brief 	Picking géométrique. L'index est une liste des widgets visibles, dans l'ordre de dessin, avec
+ *		leur rectangle visible (même découpage que \ref ei_impl_widget_draw_children), rangée dans une
+ *		grille de cases de PICK_CELL_SIZE pixels au format CSR (un tableau d'indices par case, tous
+ *		bout à bout). Il est reconstruit au premier picking qui suit une modification ; un picking
+ *		parcourt la case du point à l'envers, le premier widget dont la forme contient le point est le
+ *		plus haut.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ei_impl_pick.h"
+#include "ei_implementation.h"
+#include "ei_application.h"
+#include "var.h"
+
+#define PICK_CELL_SIZE 64
+
+/**
+ * @brief Un widget visible de l'index.
+ */
+typedef struct ei_impl_pick_item_t {
+        ei_widget_t             widget;
+        ei_rect_t               rect;           ///< partie de screen_location non coupée par les ancêtres
+} ei_impl_pick_item_t;
+
+static ei_impl_pick_mode_t      mode            = ei_impl_pick_geometric;
+static bool                     dirty           = true;
+static ei_impl_pick_item_t*     items           = NULL;
+static int                      nb_items        = 0;
+static int                      items_capacity  = 0;
+static int*                     cell_start      = NULL;  ///< cols * rows + 1 débuts dans cell_items
+static int*                     cell_items      = NULL;
+static int                      cell_items_capacity = 0;
+static int                      cols            = 0;
+static int                      rows            = 0;
+
+
+/**
+ * @brief Choisit le mode de picking au lancement (variable d'environnement EI_PICK) et crée la pick
+ * surface si ce mode est offscreen. Appelée par \ref ei_app_create.
+ *
+ * @param root_surface  la surface de la fenêtre racine
+ */
+void ei_impl_pick_init(ei_surface_t root_surface){
+        const char* env = getenv("EI_PICK");
+        mode = env && strcmp(env, "offscreen") == 0 ? ei_impl_pick_offscreen : ei_impl_pick_geometric;
+        dirty = true;
+        pick_surface = NULL;
+        if (mode == ei_impl_pick_offscreen)
+                pick_surface = hw_surface_create(root_surface, hw_surface_get_size(root_surface), false);
+}
+
+/**
+ * @return le mode de picking courant.
+ */
+ei_impl_pick_mode_t ei_impl_pick_mode(void){
+        return mode;
+}
+
+/**
+ * @brief Passe en mode offscreen (sans effet s'il l'est déjà) : crée la pick surface et demande de
+ * redessiner toute la fenêtre pour la remplir.
+ */
+void ei_impl_pick_use_offscreen(void){
+        if (mode == ei_impl_pick_offscreen) return;
+        mode = ei_impl_pick_offscreen;
+        ei_surface_t root_surface = ei_app_root_surface();
+        pick_surface = hw_surface_create(root_surface, hw_surface_get_size(root_surface), false);
+        ei_app_invalidate_rect(&ei_app_root_widget()->screen_location);
+}
+
+/**
+ * @brief A appeler à la création d'un widget : passe en mode offscreen si sa classe n'a pas de test de forme,
+ * et marque l'index à reconstruire.
+ */
+void ei_impl_pick_widget_created(ei_widget_t widget){
+        dirty = true;
+        if (mode == ei_impl_pick_geometric && !ei_impl_widgetclass_hitfunc(widget->wclass))
+                ei_impl_pick_use_offscreen();
+}
+
+/**
+ * @brief Marque l'index à reconstruire (géométrie, hiérarchie ou visibilité modifiée).
+ */
+void ei_impl_pick_invalidate(void){
+        dirty = true;
+}
+
+/*
+ * Ajoute à l'index les descendants visibles de widget, dans l'ordre de dessin. clip est la zone où widget
+ * est dessiné.
+ */
+static void collect(ei_widget_t widget, ei_rect_t clip){
+        for (ei_widget_t child = widget->children_head; child; child = child->next_sibling){
+                if (!child->geom_params || !child->geom_params->manager) continue;
+                ei_rect_t rect = get_rect_intersection(clip, child->screen_location);
+                if (rect.size.width <= 0 || rect.size.height <= 0) continue;
+                if (nb_items == items_capacity){
+                        items_capacity = items_capacity ? 2 * items_capacity : 64;
+                        items = realloc(items, items_capacity * sizeof(ei_impl_pick_item_t));
+                }
+                items[nb_items++] = (ei_impl_pick_item_t){child, rect};
+                collect(child, rect);
+        }
+}
+
+/*
+ * Cases couvertes par un rectangle (bornes incluses), false s'il est hors de la grille.
+ */
+static bool cell_range(const ei_rect_t* rect, int* c0, int* r0, int* c1, int* r1){
+        *c0 = rect->top_left.x / PICK_CELL_SIZE;
+        *r0 = rect->top_left.y / PICK_CELL_SIZE;
+        *c1 = (rect->top_left.x + rect->size.width - 1) / PICK_CELL_SIZE;
+        *r1 = (rect->top_left.y + rect->size.height - 1) / PICK_CELL_SIZE;
+        if (*c0 < 0) *c0 = 0;
+        if (*r0 < 0) *r0 = 0;
+        if (*c1 >= cols) *c1 = cols - 1;
+        if (*r1 >= rows) *r1 = rows - 1;
+        return *c0 <= *c1 && *r0 <= *r1;
+}
+
+static void rebuild(void){
+        ei_widget_t root = ei_app_root_widget();
+        ei_size_t size = root->screen_location.size;
+        int new_cols = (size.width + PICK_CELL_SIZE - 1) / PICK_CELL_SIZE;
+        int new_rows = (size.height + PICK_CELL_SIZE - 1) / PICK_CELL_SIZE;
+        if (new_cols * new_rows != cols * rows || !cell_start)
+                cell_start = realloc(cell_start, (new_cols * new_rows + 1) * sizeof(int));
+        cols = new_cols;
+        rows = new_rows;
+
+        nb_items = 0;
+        collect(root, root->screen_location);
+
+        //comptage par case, puis sommes préfixes : cell_start[c] est la fin de la case c pendant le remplissage
+        int c0, r0, c1, r1;
+        memset(cell_start, 0, (cols * rows + 1) * sizeof(int));
+        for (int i = 0; i < nb_items; i++){
+                if (!cell_range(&items[i].rect, &c0, &r0, &c1, &r1)) continue;
+                for (int r = r0; r <= r1; r++)
+                        for (int c = c0; c <= c1; c++) cell_start[r * cols + c + 1]++;
+        }
+        for (int c = 0; c < cols * rows; c++) cell_start[c + 1] += cell_start[c];
+        int total = cell_start[cols * rows];
+        if (total > cell_items_capacity){
+                cell_items = realloc(cell_items, total * sizeof(int));
+                cell_items_capacity = total;
+        }
+        int* fill = malloc((cols * rows + 1) * sizeof(int));
+        memcpy(fill, cell_start, (cols * rows + 1) * sizeof(int));
+        for (int i = 0; i < nb_items; i++){
+                if (!cell_range(&items[i].rect, &c0, &r0, &c1, &r1)) continue;
+                for (int r = r0; r <= r1; r++)
+                        for (int c = c0; c <= c1; c++) cell_items[fill[r * cols + c]++] = i;
+        }
+        free(fill);
+        dirty = false;
+}
+
+/**
+ * @brief Picking géométrique : le widget le plus haut dont la forme contient where.
+ *
+ * @return le widget, la racine s'il n'y en a aucun.
+ */
+ei_widget_t ei_impl_pick_geometric_widget(ei_point_t where){
+        ei_widget_t root = ei_app_root_widget();
+        if (dirty) rebuild();
+        if (cols == 0 || rows == 0) return root;
+        int cell = (where.y / PICK_CELL_SIZE) * cols + where.x / PICK_CELL_SIZE;
+        for (int k = cell_start[cell + 1] - 1; k >= cell_start[cell]; k--){
+                ei_impl_pick_item_t* item = &items[cell_items[k]];
+                if (where.x < item->rect.top_left.x || where.x >= item->rect.top_left.x + item->rect.size.width ||
+                    where.y < item->rect.top_left.y || where.y >= item->rect.top_left.y + item->rect.size.height)
+                        continue;
+                ei_impl_hitfunc_t hitfunc = ei_impl_widgetclass_hitfunc(item->widget->wclass);
+                if (!hitfunc || hitfunc(item->widget, where)) return item->widget;
+        }
+        return root;
+}
+
+/**
+ * @brief Libère l'index et la pick surface (appelée par \ref ei_app_free).
+ */
+void ei_impl_pick_free(void){
+        if (pick_surface) hw_surface_free(pick_surface);
+        pick_surface = NULL;
+        free(items);
+        free(cell_start);
+        free(cell_items);
+        items = NULL;
+        cell_start = NULL;
+        cell_items = NULL;
+        nb_items = items_capacity = cell_items_capacity = cols = rows = 0;
+        dirty = true;
+}
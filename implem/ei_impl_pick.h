@@ -0,0 +1,68 @@
+/**
+ * @file	ei_impl_pick.h
+ *
+ * @brief 	Picking : par défaut, \ref ei_widget_pick répond sans surface offscreen, avec une grille
+ *		uniforme sur les rectangles visibles des widgets (dans l'ordre de dessin) et le test de forme
+ *		de chaque classe (voir \ref ei_impl_widgetclass_set_hitfunc). Le mode offscreen (pick surface
+ *		dessinée en même temps que l'écran) reste disponible : il est choisi avec la variable
+ *		d'environnement EI_PICK=offscreen, ou automatiquement dès qu'un widget d'une classe sans test
+ *		de forme est créé (classe externe qui a besoin d'un picking au pixel près).
+ */
+
+#ifndef PROJETC_IG_EI_IMPL_PICK_H
+#define PROJETC_IG_EI_IMPL_PICK_H
+
+#include "ei_types.h"
+#include "ei_widget.h"
+
+/**
+ * @brief Les deux façons de répondre à \ref ei_widget_pick.
+ */
+typedef enum {
+        ei_impl_pick_geometric  = 0,    ///< grille sur les rectangles visibles + tests de forme
+        ei_impl_pick_offscreen          ///< lecture de la pick surface
+} ei_impl_pick_mode_t;
+
+/**
+ * @brief Choisit le mode de picking au lancement (variable d'environnement EI_PICK) et crée la pick
+ * surface si ce mode est offscreen. Appelée par \ref ei_app_create.
+ *
+ * @param root_surface  la surface de la fenêtre racine
+ */
+void ei_impl_pick_init(ei_surface_t root_surface);
+
+/**
+ * @return le mode de picking courant.
+ */
+ei_impl_pick_mode_t ei_impl_pick_mode(void);
+
+/**
+ * @brief Passe en mode offscreen (sans effet s'il l'est déjà) : crée la pick surface et demande de
+ * redessiner toute la fenêtre pour la remplir.
+ */
+void ei_impl_pick_use_offscreen(void);
+
+/**
+ * @brief A appeler à la création d'un widget : passe en mode offscreen si sa classe n'a pas de test de forme,
+ * et marque l'index à reconstruire.
+ */
+void ei_impl_pick_widget_created(ei_widget_t widget);
+
+/**
+ * @brief Marque l'index à reconstruire (géométrie, hiérarchie ou visibilité modifiée).
+ */
+void ei_impl_pick_invalidate(void);
+
+/**
+ * @brief Picking géométrique : le widget le plus haut dont la forme contient where.
+ *
+ * @return le widget, la racine s'il n'y en a aucun.
+ */
+ei_widget_t ei_impl_pick_geometric_widget(ei_point_t where);
+
+/**
+ * @brief Libère l'index et la pick surface (appelée par \ref ei_app_free).
+ */
+void ei_impl_pick_free(void);
+
+#endif //PROJETC_IG_EI_IMPL_PICK_H
@@ -7,26 +7,86 @@
 
 //===================================== placer
 
+ei_impl_slab_t ei_impl_placer_slab = EI_IMPL_SLAB_INIT(sizeof(ei_placer_t));
+
+/*
+ * Calcule la position et la taille du widget à partir des paramètres du placer et de la géométrie de son
+ * parent (déjà calculée : la passe de layout va de la racine vers les feuilles). La taille demandée du
+ * widget est mise à jour, la nouvelle screen_location est renvoyée sans être appliquée.
+ */
+static ei_rect_t placer_compute(ei_widget_t widget, ei_placer_t* placer){
+        ei_rect_t rect = widget->screen_location;
+        ei_widget_t parent = widget->parent;
+
+        if (placer->rel_height!=0){
+                widget->requested_size.height = (parent->requested_size.height) * (placer->rel_height);
+                rect.size.height = widget->requested_size.height;
+        }
+        if (placer->rel_width!=0){
+                widget->requested_size.width = (parent->requested_size.width) * (placer->rel_width);
+                rect.size.width = widget->requested_size.width;
+        }
+        if (placer->width!=0){
+                rect.size.width = placer->width;
+                widget->requested_size.width = placer->width;
+        }
+        if (placer->height!=0){
+                widget->requested_size.height= placer->height;
+                rect.size.height = placer->height;
+        }
+
+        //calculer x et y en fonction de l'ancrage :
+        int xpos = parent->screen_location.top_left.x, ypos = parent->screen_location.top_left.y;
+        xpos = xpos + (parent->requested_size.width) * (placer->rel_x);
+        ypos = ypos + (parent->requested_size.height) * (placer->rel_y);
+        xpos = xpos + placer->x;
+        ypos = ypos + placer->y;
+
+        switch (placer->anchor){
+                case ei_anc_none:
+                case ei_anc_northwest:
+                        break;
+                case ei_anc_north:
+                        xpos = xpos-(widget->requested_size.width)/2;
+                        break;
+                case ei_anc_northeast:
+                        xpos = xpos - widget->requested_size.width;
+                        break;
+                case ei_anc_west:
+                        ypos = ypos - widget->requested_size.height /2;
+                        break;
+                case ei_anc_center:
+                        xpos = xpos-(widget->requested_size.width)/2;
+                        ypos = ypos - widget->requested_size.height /2;
+                        break;
+                case ei_anc_east:
+                        xpos = xpos - widget->requested_size.width;
+                        ypos = ypos - widget->requested_size.height /2;
+                        break;
+                case ei_anc_southwest:
+                        ypos = ypos - widget->requested_size.height;
+                        break;
+                case ei_anc_south:
+                        xpos = xpos - widget->requested_size.width / 2;
+                        ypos = ypos - widget->requested_size.height;
+                        break;
+                case ei_anc_southeast:
+                        xpos = xpos - widget->requested_size.width;
+                        ypos = ypos - widget->requested_size.height;
+                        break;
+        }
+
+        if (xpos!= 0) rect.top_left.x = xpos;
+        if (ypos!= 0) rect.top_left.y = ypos;
+        return rect;
+}
+
 /**
-* @brief   Fonction run geometrymanager de PLACER
+* @brief   Fonction run geometrymanager de PLACER, appelée par la passe de layout (\ref ei_impl_layout_run)
 */
 void ei_impl_placer_runfunc(ei_widget_t widget){
-        int x              = ((ei_placer_t*)widget->geom_params)->x;
-        int y              = ((ei_placer_t*)widget->geom_params)->y;
-        int width          =  ((ei_placer_t*)widget->geom_params)->width;
-        int height         =  ((ei_placer_t*)widget->geom_params)->height;
-        float rel_x        =  ((ei_placer_t*)widget->geom_params)->rel_x;
-        float rel_y        =  ((ei_placer_t*)widget->geom_params)->rel_y;
-        float rel_width    =  ((ei_placer_t*)widget->geom_params)->rel_width;
-        float rel_height   =  ((ei_placer_t*)widget->geom_params)->rel_height;
-        ei_anchor_t anchor =  ((ei_placer_t*)widget->geom_params)->anchor;
-
-        ei_rect_t *old_surface = &(ei_rect_t){(ei_point_t){widget->screen_location.top_left.x, widget->screen_location.top_left.y},
-                                                  (ei_size_t){widget->screen_location.size.width,widget->screen_location.size.height}};
-
-        ei_place(widget, &anchor, &x, &y, &width, &height, &rel_x, &rel_y, &rel_width, &rel_height);
-        ei_rect_t new_surface = (widget->screen_location);
-        widget->screen_location = *old_surface;//on remet old_surface car on ferat la mise à jour de la surface dans ei_geometry_run_finalize
+        ei_rect_t new_surface = placer_compute(widget, (ei_placer_t*)widget->geom_params);
+        //ei_geometry_run_finalize met à jour la surface, abîme l'écran et marque les enfants si elle a changé
         ei_geometry_run_finalize(widget, &new_surface);
 }
 
@@ -36,6 +96,6 @@ void ei_impl_placer_runfunc(ei_widget_t widget){
  */
 void  ei_impl_placer_releasefunc(ei_widget_t widget){
         ei_app_invalidate_rect(&widget->screen_location);
-        free((ei_placer_t*)widget->geom_params);
+        ei_impl_slab_free(&ei_impl_placer_slab, widget->geom_params);
         widget->geom_params=NULL;
 }
\ No newline at end of file
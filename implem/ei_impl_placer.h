@@ -7,9 +7,15 @@
 
 #include "ei_implementation.h"
 #include "ei_placer.h"
+#include "ei_impl_slab.h"
 
 /**
- * @brief   Fonction run geometrymanager de PLACER
+ * @brief   Slab des paramètres du placer (alloués par \ref ei_place, rendus par \ref ei_impl_placer_releasefunc)
+ */
+extern ei_impl_slab_t ei_impl_placer_slab;
+
+/**
+ * @brief   Fonction run geometrymanager de PLACER, appelée par la passe de layout (\ref ei_impl_layout_run)
  */
 void ei_impl_placer_runfunc(ei_widget_t widget);
 
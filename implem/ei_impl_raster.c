@@ -0,0 +1,392 @@
+/**
+ * @file	ei_impl_raster.c
+ *
+ * @brief 	Implémentation de la rasterisation des polygones et des lignes brisées.
+ *
+ *		Polygones : les côtés sont rangés dans une table des côtés (TC) indexée par leur
+ *		première ligne visible, puis chaque ligne du clipper est balayée avec la table des
+ *		côtés actifs (TCA) triée par abscisse. Les côtés avancent d'une pente en virgule
+ *		fixe 16.16 par ligne, et chaque intervalle entre deux côtés est rempli d'un coup par
+ *		les noyaux de ei_impl_blend.h.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ei_impl_raster.h"
+#include "ei_impl_blend.h"
+#include "ei_impl_stats.h"
+#include "ei_implementation.h"
+
+/**
+ * @brief Un côté du polygone dans la TC / TCA.
+ *
+ * L'avancement le long du côté est une fraction en virgule fixe 16.16 (progress), incrémentée
+ * d'une pente constante à chaque ligne ; le reste de la division est propagé comme dans
+ * Bresenham pour que l'abscisse soit exactement celle que calcule SDL_gfx :
+ * x = progress * (x2 - x1) + x1, avec progress = (65536 * (y - y1)) / (y2 - y1).
+ */
+typedef struct ei_impl_edge_t {
+        int                     y_last;         ///< Dernière ligne où le côté est actif.
+        int64_t                 x;              ///< Abscisse à la ligne courante, en virgule fixe 16.16.
+        int64_t                 x_origin;       ///< x1, en virgule fixe 16.16.
+        int                     dx;             ///< x2 - x1.
+        int                     dy;             ///< y2 - y1 (toujours > 0).
+        int                     progress;       ///< Avancement sur le côté, en virgule fixe 16.16.
+        int                     remainder;      ///< Reste de la division de l'avancement par dy.
+        int                     slope;          ///< Partie entière de 65536 / dy : avancement par ligne.
+        int                     slope_remainder;///< Reste de 65536 / dy.
+        struct ei_impl_edge_t*  next;           ///< Côté suivant dans la même case de la TC.
+} ei_impl_edge_t;
+
+/**
+ * @brief Mémoires de travail réutilisées d'un appel à l'autre (agrandies si besoin), pour ne pas
+ * allouer à chaque polygone dessiné.
+ */
+static ei_impl_edge_t*  edges           = NULL;
+static ei_impl_edge_t** active          = NULL;
+static size_t           edges_capacity  = 0;
+static ei_impl_edge_t** table           = NULL;
+static size_t           table_capacity  = 0;
+
+
+/**
+ * @brief Calcule le rectangle de dessin : la surface, restreinte au clipper s'il y en a un.
+ *
+ * @return false si ce rectangle est vide.
+ */
+static bool raster_clip(ei_surface_t surface, const ei_rect_t* clipper, ei_rect_t* clip){
+        ei_size_t size = hw_surface_get_size(surface);
+        int x0 = 0, y0 = 0, x1 = size.width, y1 = size.height;
+        if (clipper){
+                if (clipper->top_left.x > x0) x0 = clipper->top_left.x;
+                if (clipper->top_left.y > y0) y0 = clipper->top_left.y;
+                if (clipper->top_left.x + clipper->size.width < x1)  x1 = clipper->top_left.x + clipper->size.width;
+                if (clipper->top_left.y + clipper->size.height < y1) y1 = clipper->top_left.y + clipper->size.height;
+        }
+        *clip = (ei_rect_t){{x0, y0}, {x1 - x0, y1 - y0}};
+        return x1 > x0 && y1 > y0;
+}
+
+
+/**
+ * @brief Masque du canal alpha de la surface (0 si elle n'en a pas), forcé à opaque lors des mélanges.
+ */
+static uint32_t raster_opaque_mask(ei_surface_t surface){
+        int ir, ig, ib, ia;
+        hw_surface_get_channel_indices(surface, &ir, &ig, &ib, &ia);
+        return ia < 0 ? 0 : (uint32_t)0xFF << (8 * ia);
+}
+
+
+/**
+ * @brief Agrandit les mémoires de travail pour n côtés et rows lignes.
+ *
+ * @return false si l'allocation a échoué.
+ */
+static bool raster_reserve(size_t n, size_t rows){
+        if (n > edges_capacity){
+                ei_impl_edge_t* new_edges = realloc(edges, n * sizeof(ei_impl_edge_t));
+                ei_impl_edge_t** new_active = realloc(active, n * sizeof(ei_impl_edge_t*));
+                if (new_edges) edges = new_edges;
+                if (new_active) active = new_active;
+                if (!new_edges || !new_active) return false;
+                edges_capacity = n;
+        }
+        if (rows > table_capacity){
+                ei_impl_edge_t** new_table = realloc(table, rows * sizeof(ei_impl_edge_t*));
+                if (!new_table) return false;
+                table = new_table;
+                table_capacity = rows;
+        }
+        return true;
+}
+
+
+/**
+ * @brief Arrondi de SDL_gfx d'une abscisse en virgule fixe 16.16 (au plus proche, demis vers le haut).
+ */
+static inline int raster_round(int64_t x){
+        return (int)((x >> 16) + ((x & 32768) >> 15));
+}
+
+
+/**
+ * @brief Remplit (ou mélange) les pixels [xa, xb] de la ligne row, déjà clippés.
+ */
+static inline void raster_span(uint32_t* row, int xa, int xb, uint32_t pixel, uint8_t alpha, uint32_t opaque){
+        if (alpha == 0xFF)
+                ei_impl_fill_rows(row + xa, 0, xb - xa + 1, 1, pixel);
+        else {
+                ei_impl_blend_fill_rows(row + xa, 0, xb - xa + 1, 1, pixel, alpha, opaque);
+                ei_impl_stats_count(ei_stats_pixels_blended, xb - xa + 1);
+        }
+}
+
+
+void ei_impl_raster_polygon(ei_surface_t        surface,
+                            const ei_point_t*   point_array,
+                            size_t              point_array_size,
+                            ei_color_t          color,
+                            const ei_rect_t*    clipper){
+        ei_rect_t clip;
+        if (!point_array || point_array_size < 3 || color.alpha == 0) return;
+        if (!raster_clip(surface, clipper, &clip)) return;
+
+        //bornes verticales du polygone, puis restriction au clipper avant le balayage
+        int ymin = point_array[0].y, ymax = point_array[0].y;
+        for (size_t i = 1; i < point_array_size; i++){
+                if (point_array[i].y < ymin) ymin = point_array[i].y;
+                if (point_array[i].y > ymax) ymax = point_array[i].y;
+        }
+        int y_first = ymin > clip.top_left.y ? ymin : clip.top_left.y;
+        int y_end   = ymax < clip.top_left.y + clip.size.height - 1 ? ymax : clip.top_left.y + clip.size.height - 1;
+        if (y_first > y_end) return;
+        size_t rows = (size_t)(y_end - y_first + 1);
+        if (!raster_reserve(point_array_size, rows)) return;
+        ei_impl_stats_count(ei_stats_polygons, 1);
+        memset(table, 0, rows * sizeof(ei_impl_edge_t*));
+
+        //construction de la TC : chaque côté est rangé dans la case de sa première ligne visible
+        size_t nb_edges = 0;
+        for (size_t i = 0; i < point_array_size; i++){
+                ei_point_t p1 = point_array[i];
+                ei_point_t p2 = point_array[(i + 1) % point_array_size];
+                if (p1.y == p2.y) continue; //les côtés horizontaux ne coupent aucune ligne
+                if (p1.y > p2.y){
+                        ei_point_t tmp = p1;
+                        p1 = p2;
+                        p2 = tmp;
+                }
+                //comme SDL_gfx, un côté qui finit sur la dernière ligne du polygone y est encore actif
+                int y_last = p2.y == ymax ? p2.y : p2.y - 1;
+                if (y_last < y_first || p1.y > y_end) continue;
+
+                ei_impl_edge_t* edge = &edges[nb_edges++];
+                int y_start = p1.y < y_first ? y_first : p1.y;
+                int64_t start = (int64_t)65536 * (y_start - p1.y);
+                edge->dx                = p2.x - p1.x;
+                edge->dy                = p2.y - p1.y;
+                edge->x_origin          = (int64_t)p1.x * 65536;
+                edge->slope             = 65536 / edge->dy;
+                edge->slope_remainder   = 65536 % edge->dy;
+                edge->progress          = (int)(start / edge->dy);
+                edge->remainder         = (int)(start % edge->dy);
+                edge->x                 = edge->x_origin + (int64_t)edge->progress * edge->dx;
+                edge->y_last            = y_last;
+                edge->next = table[y_start - y_first];
+                table[y_start - y_first] = edge;
+        }
+
+        uint8_t* buffer = hw_surface_get_buffer(surface);
+        int stride = hw_surface_get_size(surface).width;
+        uint32_t pixel = ei_impl_map_rgba(surface, color);
+        uint32_t opaque = color.alpha == 0xFF ? 0 : raster_opaque_mask(surface);
+        int clip_left = clip.top_left.x;
+        int clip_right = clip.top_left.x + clip.size.width - 1;
+
+        //balayage, ligne par ligne, avec la TCA
+        size_t nb_active = 0;
+        for (int y = y_first; y <= y_end; y++){
+                //on retire les côtés terminés
+                size_t kept = 0;
+                for (size_t i = 0; i < nb_active; i++)
+                        if (active[i]->y_last >= y) active[kept++] = active[i];
+                nb_active = kept;
+
+                //on ajoute les côtés qui commencent sur cette ligne
+                for (ei_impl_edge_t* edge = table[y - y_first]; edge; edge = edge->next)
+                        active[nb_active++] = edge;
+
+                //tri par insertion sur x (la TCA reste presque triée d'une ligne à l'autre)
+                for (size_t i = 1; i < nb_active; i++){
+                        ei_impl_edge_t* edge = active[i];
+                        size_t j = i;
+                        while (j > 0 && active[j - 1]->x > edge->x){
+                                active[j] = active[j - 1];
+                                j--;
+                        }
+                        active[j] = edge;
+                }
+
+                //remplissage des intervalles entre côtés pairs et impairs
+                uint32_t* row = (uint32_t*)buffer + (size_t)y * stride;
+                for (size_t i = 0; i + 1 < nb_active; i += 2){
+                        int xa = raster_round(active[i]->x + 1);
+                        int xb = raster_round(active[i + 1]->x - 1);
+                        if (xa > xb){
+                                int tmp = xa;
+                                xa = xb;
+                                xb = tmp;
+                        }
+                        if (xa < clip_left) xa = clip_left;
+                        if (xb > clip_right) xb = clip_right;
+                        if (xa <= xb) raster_span(row, xa, xb, pixel, color.alpha, opaque);
+                }
+
+                for (size_t i = 0; i < nb_active; i++){
+                        ei_impl_edge_t* edge = active[i];
+                        edge->progress  += edge->slope;
+                        edge->remainder += edge->slope_remainder;
+                        if (edge->remainder >= edge->dy){
+                                edge->remainder -= edge->dy;
+                                edge->progress++;
+                        }
+                        edge->x = edge->x_origin + (int64_t)edge->progress * edge->dx;
+                }
+        }
+}
+
+
+/**
+ * @brief Dit si \ref ei_impl_raster_polygon remplirait le pixel where, avec exactement le même calcul des
+ * intervalles (sans surface ni clipper) : sert de test de forme au picking géométrique.
+ *
+ * @param point_array   les sommets du polygone
+ * @param point_array_size le nombre de sommets (false en dessous de 3)
+ * @param where         le pixel testé
+ */
+bool ei_impl_raster_polygon_contains(const ei_point_t*  point_array,
+                                     size_t             point_array_size,
+                                     ei_point_t         where){
+        if (!point_array || point_array_size < 3) return false;
+        int ymin = point_array[0].y, ymax = point_array[0].y;
+        for (size_t i = 1; i < point_array_size; i++){
+                if (point_array[i].y < ymin) ymin = point_array[i].y;
+                if (point_array[i].y > ymax) ymax = point_array[i].y;
+        }
+        if (where.y < ymin || where.y > ymax) return false;
+
+        //abscisses des côtés actifs sur la ligne where.y : l'avancement incrémental du balayage vaut
+        //exactement la division (65536 * (y - y1)) / dy
+        int64_t xs_buffer[64];
+        int64_t* xs = point_array_size <= 64 ? xs_buffer : malloc(point_array_size * sizeof(int64_t));
+        if (!xs) return false;
+        size_t nb = 0;
+        for (size_t i = 0; i < point_array_size; i++){
+                ei_point_t p1 = point_array[i];
+                ei_point_t p2 = point_array[(i + 1) % point_array_size];
+                if (p1.y == p2.y) continue;
+                if (p1.y > p2.y){
+                        ei_point_t tmp = p1;
+                        p1 = p2;
+                        p2 = tmp;
+                }
+                int y_last = p2.y == ymax ? p2.y : p2.y - 1;
+                if (where.y < p1.y || where.y > y_last) continue;
+                int progress = (int)(((int64_t)65536 * (where.y - p1.y)) / (p2.y - p1.y));
+                int64_t x = (int64_t)p1.x * 65536 + (int64_t)progress * (p2.x - p1.x);
+                size_t j = nb++;
+                while (j > 0 && xs[j - 1] > x){
+                        xs[j] = xs[j - 1];
+                        j--;
+                }
+                xs[j] = x;
+        }
+
+        bool inside = false;
+        for (size_t i = 0; i + 1 < nb && !inside; i += 2){
+                int xa = raster_round(xs[i] + 1);
+                int xb = raster_round(xs[i + 1] - 1);
+                if (xa > xb){
+                        int tmp = xa;
+                        xa = xb;
+                        xb = tmp;
+                }
+                inside = xa <= where.x && where.x <= xb;
+        }
+        if (xs != xs_buffer) free(xs);
+        return inside;
+}
+
+
+/**
+ * @brief Écrit (ou mélange) un pixel s'il est dans le rectangle de dessin.
+ */
+static inline void raster_plot(uint8_t* buffer, int stride, const ei_rect_t* clip, int x, int y,
+                               uint32_t pixel, uint8_t alpha, uint32_t opaque){
+        if (x < clip->top_left.x || x >= clip->top_left.x + clip->size.width ||
+            y < clip->top_left.y || y >= clip->top_left.y + clip->size.height)
+                return;
+        uint32_t* p = (uint32_t*)buffer + (size_t)y * stride + x;
+        if (alpha == 0xFF) *p = pixel;
+        else ei_impl_blend_fill_rows(p, 0, 1, 1, pixel, alpha, opaque);
+}
+
+
+/**
+ * @brief Trace le segment p1 -> p2 par l'algorithme de Bresenham. Le dernier point n'est pas
+ * tracé si with_last est false.
+ */
+static void raster_segment(uint8_t* buffer, int stride, const ei_rect_t* clip, ei_point_t p1, ei_point_t p2,
+                           bool with_last, uint32_t pixel, uint8_t alpha, uint32_t opaque){
+        //segment entièrement hors du clipper : rien à faire
+        int min_x = p1.x < p2.x ? p1.x : p2.x, max_x = p1.x < p2.x ? p2.x : p1.x;
+        int min_y = p1.y < p2.y ? p1.y : p2.y, max_y = p1.y < p2.y ? p2.y : p1.y;
+        if (max_x < clip->top_left.x || min_x >= clip->top_left.x + clip->size.width ||
+            max_y < clip->top_left.y || min_y >= clip->top_left.y + clip->size.height)
+                return;
+
+        //segment horizontal : un seul intervalle
+        if (p1.y == p2.y){
+                int xa = min_x, xb = max_x;
+                if (!with_last){
+                        if (p2.x > p1.x) xb--;
+                        else xa++;
+                }
+                if (xa < clip->top_left.x) xa = clip->top_left.x;
+                if (xb > clip->top_left.x + clip->size.width - 1) xb = clip->top_left.x + clip->size.width - 1;
+                if (xa <= xb) raster_span((uint32_t*)buffer + (size_t)p1.y * stride, xa, xb, pixel, alpha, opaque);
+                return;
+        }
+
+        int dx = abs(p2.x - p1.x), sx = p1.x < p2.x ? 1 : -1;
+        int dy = -abs(p2.y - p1.y), sy = p1.y < p2.y ? 1 : -1;
+        int err = dx + dy;
+        int x = p1.x, y = p1.y;
+        while (true){
+                bool last = x == p2.x && y == p2.y;
+                if (last && !with_last) return;
+                raster_plot(buffer, stride, clip, x, y, pixel, alpha, opaque);
+                if (last) return;
+                int e2 = 2 * err;
+                if (e2 >= dy){
+                        err += dy;
+                        x += sx;
+                }
+                if (e2 <= dx){
+                        err += dx;
+                        y += sy;
+                }
+        }
+}
+
+
+void ei_impl_raster_polyline(ei_surface_t       surface,
+                             const ei_point_t*  point_array,
+                             size_t             point_array_size,
+                             ei_color_t         color,
+                             const ei_rect_t*   clipper){
+        ei_rect_t clip;
+        if (!point_array || point_array_size == 0 || color.alpha == 0) return;
+        if (!raster_clip(surface, clipper, &clip)) return;
+
+        uint8_t* buffer = hw_surface_get_buffer(surface);
+        int stride = hw_surface_get_size(surface).width;
+        uint32_t pixel = ei_impl_map_rgba(surface, color);
+        uint32_t opaque = color.alpha == 0xFF ? 0 : raster_opaque_mask(surface);
+
+        if (point_array_size == 1){
+                raster_plot(buffer, stride, &clip, point_array[0].x, point_array[0].y, pixel, color.alpha, opaque);
+                return;
+        }
+
+        //chaque segment s'arrête juste avant son dernier point, qui est le premier du segment suivant
+        ei_point_t first = point_array[0];
+        ei_point_t last = point_array[point_array_size - 1];
+        bool closed = first.x == last.x && first.y == last.y;
+        for (size_t i = 0; i + 1 < point_array_size; i++){
+                bool with_last = i + 2 == point_array_size && (!closed || point_array_size == 2);
+                raster_segment(buffer, stride, &clip, point_array[i], point_array[i + 1], with_last,
+                               pixel, color.alpha, opaque);
+        }
+}
@@ -0,0 +1,62 @@
+/**
+ * @file	ei_impl_raster.h
+ *
+ * @brief 	Rasterisation des polygones (table des côtés / table des côtés actifs) et des lignes
+ *		brisées, utilisée par \ref ei_draw_polygon et \ref ei_draw_polyline.
+ *
+ *		A l'édition de liens, ce module ne dépend que de hw_interface et de ei_impl_blend.c :
+ *		il peut être lié sans le reste de libei (voir tests/bench_polygon.c).
+ */
+
+#ifndef PROJETC_IG_EI_IMPL_RASTER_H
+#define PROJETC_IG_EI_IMPL_RASTER_H
+
+#include <stddef.h>
+#include "ei_types.h"
+#include "hw_interface.h"
+
+/**
+ * @brief Remplit un polygone par balayage de lignes. Mêmes conventions que la version de libeibase
+ * (SDL_gfx) : les bords droit et bas sont inclus, la dernière ligne du polygone est remplie.
+ *
+ * @param surface       surface verrouillée où dessiner
+ * @param point_array   les sommets du polygone
+ * @param point_array_size le nombre de sommets (rien n'est dessiné en dessous de 3)
+ * @param color         la couleur, l'alpha est géré
+ * @param clipper       si non NULL, le dessin est restreint à ce rectangle
+ */
+void ei_impl_raster_polygon(ei_surface_t        surface,
+                            const ei_point_t*   point_array,
+                            size_t              point_array_size,
+                            ei_color_t          color,
+                            const ei_rect_t*    clipper);
+
+/**
+ * @brief Dit si \ref ei_impl_raster_polygon remplirait le pixel where, avec exactement le même calcul des
+ * intervalles (sans surface ni clipper) : sert de test de forme au picking géométrique.
+ *
+ * @param point_array   les sommets du polygone
+ * @param point_array_size le nombre de sommets (false en dessous de 3)
+ * @param where         le pixel testé
+ */
+bool ei_impl_raster_polygon_contains(const ei_point_t*  point_array,
+                                     size_t             point_array_size,
+                                     ei_point_t         where);
+
+/**
+ * @brief Trace une ligne brisée (Bresenham). Chaque pixel n'est écrit qu'une fois, y compris les
+ * sommets partagés par deux segments et le dernier point s'il est égal au premier.
+ *
+ * @param surface       surface verrouillée où dessiner
+ * @param point_array   les points de la ligne brisée
+ * @param point_array_size le nombre de points (peut être 0 ou 1)
+ * @param color         la couleur, l'alpha est géré
+ * @param clipper       si non NULL, le dessin est restreint à ce rectangle
+ */
+void ei_impl_raster_polyline(ei_surface_t       surface,
+                             const ei_point_t*  point_array,
+                             size_t             point_array_size,
+                             ei_color_t         color,
+                             const ei_rect_t*   clipper);
+
+#endif //PROJETC_IG_EI_IMPL_RASTER_H
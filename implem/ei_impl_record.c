@@ -0,0 +1,322 @@
+/**
+ * @file	ei_impl_record.c
+ *
+ * @brief 	Enregistrement et rejeu des évènements de la boucle principale.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ei_impl_record.h"
+#include "ei_impl_frame.h"
+#include "ei_impl_stats.h"
+#include "ei_application.h"
+#include "hw_interface.h"
+
+/**
+ * @brief Ce que fait la boucle principale de ses évènements.
+ */
+typedef enum {
+        ei_impl_record_off      = 0,
+        ei_impl_record_on,              ///< ils sont écrits dans le fichier
+        ei_impl_record_replay           ///< ils sont remplacés par ceux du fichier
+} ei_impl_record_mode_t;
+
+static ei_impl_record_mode_t    mode            = ei_impl_record_off;
+static FILE*                    file            = NULL;
+static const char*              path            = NULL;
+static double                   last_time       = 0;     ///< date du dernier évènement enregistré ou rejoué
+static bool                     fast            = false;
+static ei_event_t               next_event;              ///< prochain évènement du rejeu, lu à l'avance
+static double                   next_delay      = 0;
+static bool                     has_next        = false;
+static bool                     armed           = false; ///< un réveil du rejeu est en attente
+static void*                    wakeup          = NULL;  ///< son identifiant (NULL s'il a été posté sans délai)
+static int                      replay_tag;              ///< son adresse identifie les réveils du rejeu
+static uint64_t                 replayed        = 0;
+static double                   wall_start      = 0;
+static double                   wall_end        = 0;
+
+
+static void put_u8(FILE* f, uint8_t v){
+        fputc(v, f);
+}
+
+static void put_u16(FILE* f, uint16_t v){
+        put_u8(f, v & 0xFF);
+        put_u8(f, v >> 8);
+}
+
+static void put_u32(FILE* f, uint32_t v){
+        put_u16(f, v & 0xFFFF);
+        put_u16(f, v >> 16);
+}
+
+/*
+ * Lit n octets little-endian ; renvoie false à la fin du fichier.
+ */
+static bool get_le(FILE* f, int n, uint32_t* v){
+        *v = 0;
+        for (int i = 0; i < n; i++){
+                int c = fgetc(f);
+                if (c == EOF) return false;
+                *v |= (uint32_t)c << (8 * i);
+        }
+        return true;
+}
+
+/**
+ * @brief Ouvre un fichier d'évènements en écriture et écrit son en-tête. Renvoie NULL en cas d'échec.
+ *
+ * @param path          le fichier
+ * @param root_size     la taille de la fenêtre racine de l'application enregistrée
+ */
+FILE* ei_impl_record_open(const char* path, ei_size_t root_size){
+        FILE* f = fopen(path, "wb");
+        if (!f) return NULL;
+        fwrite(EI_IMPL_RECORD_MAGIC, 1, 4, f);
+        put_u8(f, EI_IMPL_RECORD_VERSION);
+        put_u16(f, (uint16_t)root_size.width);
+        put_u16(f, (uint16_t)root_size.height);
+        return f;
+}
+
+/**
+ * @brief Ecrit un évènement (les évènements application ne sont pas enregistrables et sont ignorés).
+ *
+ * @param file          le fichier ouvert par \ref ei_impl_record_open
+ * @param event         l'évènement
+ * @param delay         le délai depuis l'évènement précédent, en secondes
+ */
+void ei_impl_record_write(FILE* file, const ei_event_t* event, double delay){
+        if (event->type == ei_ev_app || event->type <= ei_ev_none || event->type >= ei_ev_last) return;
+        double us = delay > 0 ? delay * 1e6 + 0.5 : 0;
+        put_u32(file, us > UINT32_MAX ? UINT32_MAX : (uint32_t)us);
+        put_u8(file, (uint8_t)event->type);
+        put_u32(file, event->modifier_mask);
+        switch (event->type){
+                case ei_ev_keydown:
+                case ei_ev_keyup:
+                        put_u32(file, (uint32_t)event->param.key_code);
+                        break;
+                case ei_ev_text_input:
+                        put_u8(file, (uint8_t)event->param.text);
+                        break;
+                case ei_ev_mouse_buttondown:
+                case ei_ev_mouse_buttonup:
+                case ei_ev_mouse_move:
+                case ei_ev_mouse_wheel:
+                        put_u16(file, (uint16_t)event->param.mouse.where.x);
+                        put_u16(file, (uint16_t)event->param.mouse.where.y);
+                        if (event->type == ei_ev_mouse_move) break;
+                        if (event->type == ei_ev_mouse_wheel){
+                                uint32_t bits;
+                                memcpy(&bits, &event->param.mouse.wheel, sizeof(bits));
+                                put_u32(file, bits);
+                        } else put_u8(file, (uint8_t)event->param.mouse.button);
+                        break;
+                default:
+                        break;
+        }
+}
+
+/**
+ * @brief Ouvre un fichier d'évènements en lecture et vérifie son en-tête. Renvoie NULL en cas d'échec.
+ *
+ * @param path          le fichier
+ * @param root_size     si non NULL, reçoit la taille de la fenêtre racine enregistrée
+ */
+FILE* ei_impl_record_open_replay(const char* path, ei_size_t* root_size){
+        FILE* f = fopen(path, "rb");
+        if (!f) return NULL;
+        char magic[4];
+        uint32_t version, width, height;
+        if (fread(magic, 1, 4, f) != 4 || memcmp(magic, EI_IMPL_RECORD_MAGIC, 4) != 0
+            || !get_le(f, 1, &version) || version != EI_IMPL_RECORD_VERSION
+            || !get_le(f, 2, &width) || !get_le(f, 2, &height)){
+                fclose(f);
+                return NULL;
+        }
+        if (root_size) *root_size = (ei_size_t){(int)width, (int)height};
+        return f;
+}
+
+/**
+ * @brief Lit l'évènement suivant. Renvoie false à la fin du fichier.
+ *
+ * @param file          le fichier ouvert par \ref ei_impl_record_open_replay
+ * @param event         reçoit l'évènement
+ * @param delay         reçoit le délai depuis l'évènement précédent, en secondes
+ */
+bool ei_impl_record_read(FILE* file, ei_event_t* event, double* delay){
+        uint32_t us, type, mask, a, b;
+        if (!get_le(file, 4, &us) || !get_le(file, 1, &type) || !get_le(file, 4, &mask)) return false;
+        if (type <= ei_ev_app || type >= ei_ev_last) return false;
+        memset(event, 0, sizeof(ei_event_t));
+        event->type = (ei_eventtype_t)type;
+        event->modifier_mask = mask;
+        *delay = us / 1e6;
+        switch (event->type){
+                case ei_ev_keydown:
+                case ei_ev_keyup:
+                        if (!get_le(file, 4, &a)) return false;
+                        event->param.key_code = (SDL_Keycode)(int32_t)a;
+                        return true;
+                case ei_ev_text_input:
+                        if (!get_le(file, 1, &a)) return false;
+                        event->param.text = (char)a;
+                        return true;
+                case ei_ev_mouse_buttondown:
+                case ei_ev_mouse_buttonup:
+                case ei_ev_mouse_move:
+                case ei_ev_mouse_wheel:
+                        if (!get_le(file, 2, &a) || !get_le(file, 2, &b)) return false;
+                        event->param.mouse.where = (ei_point_t){(int16_t)a, (int16_t)b};
+                        if (event->type == ei_ev_mouse_move) return true;
+                        if (event->type == ei_ev_mouse_wheel){
+                                if (!get_le(file, 4, &a)) return false;
+                                memcpy(&event->param.mouse.wheel, &a, sizeof(float));
+                        } else {
+                                if (!get_le(file, 1, &a)) return false;
+                                event->param.mouse.button = (ei_mouse_button_t)a;
+                        }
+                        return true;
+                default:
+                        return true;
+        }
+}
+
+/*
+ * Programme le réveil qui rendra le prochain évènement du fichier (ou terminera le rejeu) : à sa date
+ * enregistrée, ou tout de suite en rejeu rapide. Les évènements application déjà échus passent avant.
+ */
+static void arm(void){
+        int ms = 0;
+        if (!fast && has_next) ms = (int)((last_time + next_delay - hw_now()) * 1000.0 + 0.5);
+        armed = true;
+        if (ms > 0) wakeup = hw_event_schedule_app(ms, &replay_tag);
+        else {
+                wakeup = NULL;
+                hw_event_post_app(&replay_tag);
+        }
+}
+
+/**
+ * @brief Lit les variables d'environnement EI_RECORD, EI_REPLAY et EI_REPLAY_FAST et commence
+ * l'enregistrement ou le rejeu. Appelée par \ref ei_app_run, après \ref ei_impl_frame_init.
+ */
+void ei_impl_record_init(void){
+        const char* replay_path = getenv("EI_REPLAY");
+        const char* record_path = getenv("EI_RECORD");
+        ei_size_t root_size = hw_surface_get_size(ei_app_root_surface());
+        mode = ei_impl_record_off;
+        last_time = hw_now();
+        if (replay_path && *replay_path){
+                ei_size_t recorded;
+                file = ei_impl_record_open_replay(replay_path, &recorded);
+                if (!file){
+                        fprintf(stderr, "replay: cannot read %s\n", replay_path);
+                        return;
+                }
+                if (recorded.width != root_size.width || recorded.height != root_size.height)
+                        fprintf(stderr, "replay: %s was recorded in a %dx%d window, this one is %dx%d\n",
+                                replay_path, recorded.width, recorded.height, root_size.width, root_size.height);
+                mode = ei_impl_record_replay;
+                path = replay_path;
+                const char* env = getenv("EI_REPLAY_FAST");
+                fast = env && strcmp(env, "0") != 0;
+                //en rejeu rapide, pas de période d'image : chaque évènement produit son image
+                if (fast) ei_impl_frame_set_period(0);
+                //le rapport du rejeu vient du profiler
+                ei_impl_stats_enabled = true;
+                replayed = 0;
+                has_next = ei_impl_record_read(file, &next_event, &next_delay);
+                wall_start = wall_end = ei_impl_stats_now();
+                arm();
+        } else if (record_path && *record_path){
+                file = ei_impl_record_open(record_path, root_size);
+                if (!file){
+                        fprintf(stderr, "record: cannot write %s\n", record_path);
+                        return;
+                }
+                mode = ei_impl_record_on;
+                path = record_path;
+        }
+}
+
+/*
+ * Réveil du rejeu : rend l'évènement suivant du fichier dans event, ou demande à quitter s'il n'y en a plus
+ * (event est alors ei_ev_none).
+ */
+static void replay_step(ei_event_t* event){
+        armed = false;
+        wakeup = NULL;
+        if (!has_next){
+                wall_end = ei_impl_stats_now();
+                memset(event, 0, sizeof(ei_event_t));
+                ei_app_quit_request();
+                return;
+        }
+        *event = next_event;
+        //la date enregistrée, et non celle du réveil : le retard d'un évènement ne décale pas les suivants
+        last_time = fast ? hw_now() : last_time + next_delay;
+        replayed++;
+        has_next = ei_impl_record_read(file, &next_event, &next_delay);
+        arm();
+}
+
+/**
+ * @brief Remplace \ref hw_event_wait_next dans la boucle principale : attend l'évènement suivant et
+ * l'enregistre, ou, pendant un rejeu, renvoie l'évènement suivant du fichier à sa date (les entrées de
+ * l'utilisateur sont ignorées, les évènements application et la fermeture de la fenêtre passent).
+ *
+ * @param event reçoit l'évènement
+ */
+void ei_impl_record_next(ei_event_t* event){
+        for (;;){
+                hw_event_wait_next(event);
+                if (mode == ei_impl_record_replay){
+                        if (event->type == ei_ev_app && event->param.application.user_param == &replay_tag){
+                                replay_step(event);
+                                return;
+                        }
+                        if (event->type == ei_ev_app || event->type == ei_ev_close) return;
+                        continue;
+                }
+                if (mode == ei_impl_record_on && event->type != ei_ev_app){
+                        double now = hw_now();
+                        ei_impl_record_write(file, event, now - last_time);
+                        last_time = now;
+                }
+                return;
+        }
+}
+
+/*
+ * Rapport du rejeu : nombre d'évènements et d'images, durée réelle, distribution des durées d'image.
+ */
+static void replay_report(FILE* out){
+        ei_stats_summary_t frames;
+        ei_impl_stats_summary(ei_stats_frame, &frames);
+        fprintf(out, "replay %s (%s): %llu events in %.1f ms\n", path, fast ? "fast" : "recorded speed",
+                (unsigned long long)replayed, (wall_end - wall_start) * 1000);
+        fprintf(out, "frames %llu: p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+                (unsigned long long)frames.count, frames.p50 * 1000, frames.p95 * 1000, frames.p99 * 1000,
+                frames.max * 1000);
+}
+
+/**
+ * @brief Ferme le fichier, annule le réveil du rejeu et affiche son rapport (appelée par \ref ei_app_free).
+ */
+void ei_impl_record_free(void){
+        if (mode == ei_impl_record_replay){
+                if (wall_end == wall_start) wall_end = ei_impl_stats_now();
+                replay_report(stderr);
+        }
+        if (armed && wakeup) hw_event_cancel_app(wakeup);
+        armed = false;
+        wakeup = NULL;
+        if (file) fclose(file);
+        file = NULL;
+        path = NULL;
+        mode = ei_impl_record_off;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file	ei_impl_record.h
+ *
+ * @brief 	Enregistrement et rejeu des évènements de la boucle principale, pour des mesures de performance
+ *		reproductibles. Avec la variable d'environnement EI_RECORD=fichier, chaque évènement renvoyé par
+ *		\ref hw_event_wait_next (sauf les évènements application) est écrit dans le fichier avec sa date.
+ *		Avec EI_REPLAY=fichier, les évènements du fichier remplacent ceux de l'utilisateur : ils sont
+ *		rendus à leur date enregistrée, par un réveil \ref hw_event_schedule_app, ou à la suite si
+ *		EI_REPLAY_FAST est définie (la période d'image est alors 0 : une image par évènement).
+ *		L'application quitte à la fin du fichier et le rejeu affiche la distribution des durées d'image.
+ *
+ *		Format (entiers little-endian) : l'en-tête "EIRC", la version (u8), la taille de la fenêtre
+ *		racine (2 x u16) ; puis pour chaque évènement : le délai depuis le précédent en microsecondes
+ *		(u32), le type (u8), les modificateurs (u32) et les paramètres du type : key_code (i32), le
+ *		caractère (u8), ou la position de la souris (2 x i16) suivie du bouton (u8) ou de la molette
+ *		(float, 4 octets).
+ */
+
+#ifndef PROJETC_IG_EI_IMPL_RECORD_H
+#define PROJETC_IG_EI_IMPL_RECORD_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "ei_event.h"
+
+#define EI_IMPL_RECORD_MAGIC    "EIRC"
+#define EI_IMPL_RECORD_VERSION  1
+
+/**
+ * @brief Ouvre un fichier d'évènements en écriture et écrit son en-tête. Renvoie NULL en cas d'échec.
+ *
+ * @param path          le fichier
+ * @param root_size     la taille de la fenêtre racine de l'application enregistrée
+ */
+FILE* ei_impl_record_open(const char* path, ei_size_t root_size);
+
+/**
+ * @brief Ecrit un évènement (les évènements application ne sont pas enregistrables et sont ignorés).
+ *
+ * @param file          le fichier ouvert par \ref ei_impl_record_open
+ * @param event         l'évènement
+ * @param delay         le délai depuis l'évènement précédent, en secondes
+ */
+void ei_impl_record_write(FILE* file, const ei_event_t* event, double delay);
+
+/**
+ * @brief Ouvre un fichier d'évènements en lecture et vérifie son en-tête. Renvoie NULL en cas d'échec.
+ *
+ * @param path          le fichier
+ * @param root_size     si non NULL, reçoit la taille de la fenêtre racine enregistrée
+ */
+FILE* ei_impl_record_open_replay(const char* path, ei_size_t* root_size);
+
+/**
+ * @brief Lit l'évènement suivant. Renvoie false à la fin du fichier.
+ *
+ * @param file          le fichier ouvert par \ref ei_impl_record_open_replay
+ * @param event         reçoit l'évènement
+ * @param delay         reçoit le délai depuis l'évènement précédent, en secondes
+ */
+bool ei_impl_record_read(FILE* file, ei_event_t* event, double* delay);
+
+/**
+ * @brief Lit les variables d'environnement EI_RECORD, EI_REPLAY et EI_REPLAY_FAST et commence
+ * l'enregistrement ou le rejeu. Appelée par \ref ei_app_run, après \ref ei_impl_frame_init.
+ */
+void ei_impl_record_init(void);
+
+/**
+ * @brief Remplace \ref hw_event_wait_next dans la boucle principale : attend l'évènement suivant et
+ * l'enregistre, ou, pendant un rejeu, renvoie l'évènement suivant du fichier à sa date (les entrées de
+ * l'utilisateur sont ignorées, les évènements application et la fermeture de la fenêtre passent).
+ *
+ * @param event reçoit l'évènement
+ */
+void ei_impl_record_next(ei_event_t* event);
+
+/**
+ * @brief Ferme le fichier, annule le réveil du rejeu et affiche son rapport (appelée par \ref ei_app_free).
+ */
+void ei_impl_record_free(void);
+
+#endif //PROJETC_IG_EI_IMPL_RECORD_H
@@ -0,0 +1,300 @@
+/**
+ * @file	ei_impl_region.c
+ *
+ * @brief 	Algèbre des régions en bandes. Les trois opérations passent par region_op, qui parcourt les
+ *		bandes des deux régions de haut en bas (comme miRegionOp de X11) : sur chaque tranche
+ *		horizontale où aucune des deux régions ne change, les intervalles en x des deux bandes sont
+ *		combinés par balayage de leurs bords, puis la bande résultat est ajoutée (et fusionnée avec
+ *		la précédente si elle la prolonge).
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "ei_impl_region.h"
+
+enum { region_union, region_intersect, region_subtract };
+
+
+/**
+ * @brief Initialise une région vide.
+ */
+void ei_region_init(ei_region_t* region){
+        memset(region, 0, sizeof(ei_region_t));
+}
+
+/**
+ * @brief Libère la mémoire d'une région, qui redevient vide.
+ */
+void ei_region_free(ei_region_t* region){
+        free(region->boxes);
+        ei_region_init(region);
+}
+
+/**
+ * @brief Vide une région en gardant sa mémoire.
+ */
+void ei_region_clear(ei_region_t* region){
+        region->size = 0;
+        region->extents = (ei_region_box_t){0, 0, 0, 0};
+}
+
+/**
+ * @return true si la région ne contient aucun pixel.
+ */
+bool ei_region_is_empty(const ei_region_t* region){
+        return region->size == 0;
+}
+
+static void reserve(ei_region_t* region, int size){
+        if (size <= region->capacity) return;
+        int capacity = region->capacity ? region->capacity : 8;
+        while (capacity < size) capacity *= 2;
+        region->boxes = realloc(region->boxes, capacity * sizeof(ei_region_box_t));
+        region->capacity = capacity;
+}
+
+static void compute_extents(ei_region_t* region){
+        if (region->size == 0){
+                region->extents = (ei_region_box_t){0, 0, 0, 0};
+                return;
+        }
+        ei_region_box_t extents = {INT_MAX, region->boxes[0].y1, INT_MIN, region->boxes[region->size - 1].y2};
+        for (int i = 0; i < region->size; i++){
+                if (region->boxes[i].x1 < extents.x1) extents.x1 = region->boxes[i].x1;
+                if (region->boxes[i].x2 > extents.x2) extents.x2 = region->boxes[i].x2;
+        }
+        region->extents = extents;
+}
+
+/**
+ * @brief Remplace le contenu de region par le rectangle rect (vide si rect est vide).
+ */
+void ei_region_set_rect(ei_region_t* region, const ei_rect_t* rect){
+        ei_region_clear(region);
+        if (rect->size.width <= 0 || rect->size.height <= 0) return;
+        reserve(region, 1);
+        region->boxes[0] = (ei_region_box_t){rect->top_left.x, rect->top_left.y,
+                                             rect->top_left.x + rect->size.width, rect->top_left.y + rect->size.height};
+        region->extents = region->boxes[0];
+        region->size = 1;
+}
+
+/*
+ * Renvoie l'indice de fin (exclu) de la bande qui commence à l'indice start.
+ */
+static int band_end(const ei_region_t* region, int start){
+        int end = start + 1;
+        while (end < region->size && region->boxes[end].y1 == region->boxes[start].y1) end++;
+        return end;
+}
+
+static bool apply(int op, bool in_a, bool in_b){
+        switch (op){
+                case region_union:      return in_a || in_b;
+                case region_intersect:  return in_a && in_b;
+                default:                return in_a && !in_b;
+        }
+}
+
+/*
+ * Ajoute à result la bande [y1, y2[ obtenue en combinant les intervalles en x de a[0..na[ et b[0..nb[.
+ * Si la bande précédente (qui commence à l'indice *previous) touche celle-ci et a les mêmes intervalles,
+ * elle est simplement prolongée.
+ */
+static void combine_band(ei_region_t* result, int* previous, int op, int y1, int y2,
+                         const ei_region_box_t* a, int na, const ei_region_box_t* b, int nb){
+        int     start   = result->size;
+        int     ka      = 0;
+        int     kb      = 0;
+        bool    in_a    = false;
+        bool    in_b    = false;
+        bool    inside  = false;
+        int     x_start = 0;
+
+        //chaque liste a 2n bords, strictement croissants : x1 du rectangle k/2 si k est pair, x2 sinon
+        while (ka < 2 * na || kb < 2 * nb){
+                int xa = ka < 2 * na ? ((ka & 1) ? a[ka / 2].x2 : a[ka / 2].x1) : INT_MAX;
+                int xb = kb < 2 * nb ? ((kb & 1) ? b[kb / 2].x2 : b[kb / 2].x1) : INT_MAX;
+                int x = xa < xb ? xa : xb;
+                if (xa == x) { in_a = !in_a; ka++; }
+                if (xb == x) { in_b = !in_b; kb++; }
+                bool now = apply(op, in_a, in_b);
+                if (now && !inside){
+                        x_start = x;
+                } else if (!now && inside){
+                        reserve(result, result->size + 1);
+                        result->boxes[result->size++] = (ei_region_box_t){x_start, y1, x, y2};
+                }
+                inside = now;
+        }
+        if (result->size == start) return;
+
+        int count = result->size - start;
+        if (*previous >= 0 && start - *previous == count && result->boxes[*previous].y2 == y1){
+                bool same = true;
+                for (int i = 0; i < count && same; i++)
+                        same = result->boxes[*previous + i].x1 == result->boxes[start + i].x1 &&
+                               result->boxes[*previous + i].x2 == result->boxes[start + i].x2;
+                if (same){
+                        for (int i = 0; i < count; i++)
+                                result->boxes[*previous + i].y2 = y2;
+                        result->size = start;
+                        return;
+                }
+        }
+        *previous = start;
+}
+
+/*
+ * result = a op b, par parcours simultané des bandes de a et de b.
+ */
+static void region_op(ei_region_t* result, const ei_region_t* a, const ei_region_t* b, int op){
+        ei_region_t     out;
+        int             ia      = 0;
+        int             ib      = 0;
+        int             y       = INT_MIN;
+        int             previous = -1;
+
+        ei_region_init(&out);
+        reserve(&out, a->size + b->size);
+        while (ia < a->size || ib < b->size){
+                int a_end = ia < a->size ? band_end(a, ia) : ia;
+                int b_end = ib < b->size ? band_end(b, ib) : ib;
+                //on ne parcourt qu'une partie d'une bande : celle sous la position courante y
+                int a_top = ia < a->size ? (a->boxes[ia].y1 > y ? a->boxes[ia].y1 : y) : INT_MAX;
+                int b_top = ib < b->size ? (b->boxes[ib].y1 > y ? b->boxes[ib].y1 : y) : INT_MAX;
+                int top = a_top < b_top ? a_top : b_top;
+                bool a_active = a_top == top;
+                bool b_active = b_top == top;
+
+                //la tranche s'arrête au premier bord horizontal rencontré dans a ou dans b
+                int bottom = INT_MAX;
+                if (a_active) bottom = a->boxes[ia].y2;
+                else if (ia < a->size) bottom = a->boxes[ia].y1;
+                if (b_active && b->boxes[ib].y2 < bottom) bottom = b->boxes[ib].y2;
+                else if (!b_active && ib < b->size && b->boxes[ib].y1 < bottom) bottom = b->boxes[ib].y1;
+
+                //pas la peine de combiner si le résultat est forcément vide sur la tranche
+                if (!(op == region_intersect && !(a_active && b_active)) && !(op == region_subtract && !a_active))
+                        combine_band(&out, &previous, op, top, bottom,
+                                     a->boxes + ia, a_active ? a_end - ia : 0,
+                                     b->boxes + ib, b_active ? b_end - ib : 0);
+
+                y = bottom;
+                if (a_active && a->boxes[ia].y2 == bottom) ia = a_end;
+                if (b_active && b->boxes[ib].y2 == bottom) ib = b_end;
+                if (op != region_union && ia >= a->size) break;
+                if (op == region_intersect && ib >= b->size) break;
+        }
+
+        compute_extents(&out);
+        free(result->boxes);
+        *result = out;
+}
+
+/**
+ * @brief result = a U b. result peut être a ou b.
+ */
+void ei_region_union(ei_region_t* result, const ei_region_t* a, const ei_region_t* b){
+        region_op(result, a, b, region_union);
+}
+
+/**
+ * @brief result = a inter b. result peut être a ou b.
+ */
+void ei_region_intersect(ei_region_t* result, const ei_region_t* a, const ei_region_t* b){
+        region_op(result, a, b, region_intersect);
+}
+
+/**
+ * @brief result = a \ b. result peut être a ou b.
+ */
+void ei_region_subtract(ei_region_t* result, const ei_region_t* a, const ei_region_t* b){
+        region_op(result, a, b, region_subtract);
+}
+
+/*
+ * Une région d'un seul rectangle, sans allocation.
+ */
+static ei_region_t rect_region(const ei_rect_t* rect, ei_region_box_t* box){
+        ei_region_t region = {box, 1, 1, {0, 0, 0, 0}};
+        *box = (ei_region_box_t){rect->top_left.x, rect->top_left.y,
+                                 rect->top_left.x + rect->size.width, rect->top_left.y + rect->size.height};
+        if (rect->size.width <= 0 || rect->size.height <= 0) region.size = 0;
+        else region.extents = *box;
+        return region;
+}
+
+static bool box_contains(const ei_region_box_t* outer, const ei_region_box_t* inner){
+        return outer->x1 <= inner->x1 && outer->y1 <= inner->y1 && outer->x2 >= inner->x2 && outer->y2 >= inner->y2;
+}
+
+/**
+ * @brief region = region U rect.
+ */
+void ei_region_union_rect(ei_region_t* region, const ei_rect_t* rect){
+        ei_region_box_t box;
+        ei_region_t other = rect_region(rect, &box);
+        if (other.size == 0) return;
+        //cas fréquents : rectangle déjà couvert, ou région vide
+        if (region->size == 1 && box_contains(&region->boxes[0], &box)) return;
+        if (region->size == 0 || box_contains(&box, &region->extents)){
+                ei_region_set_rect(region, rect);
+                return;
+        }
+        region_op(region, region, &other, region_union);
+}
+
+/**
+ * @brief region = region inter rect.
+ */
+void ei_region_intersect_rect(ei_region_t* region, const ei_rect_t* rect){
+        ei_region_box_t box;
+        ei_region_t other = rect_region(rect, &box);
+        if (region->size && other.size && box_contains(&box, &region->extents)) return;
+        region_op(region, region, &other, region_intersect);
+}
+
+/**
+ * @brief region = region \ rect.
+ */
+void ei_region_subtract_rect(ei_region_t* region, const ei_rect_t* rect){
+        ei_region_box_t box;
+        ei_region_t other = rect_region(rect, &box);
+        if (region->size == 0 || other.size == 0) return;
+        region_op(region, region, &other, region_subtract);
+}
+
+/**
+ * @brief Renvoie le i-ème rectangle de la région (0 <= i < region->size) au format \ref ei_rect_t.
+ */
+ei_rect_t ei_region_rect(const ei_region_t* region, int i){
+        const ei_region_box_t* box = &region->boxes[i];
+        return (ei_rect_t){{box->x1, box->y1}, {box->x2 - box->x1, box->y2 - box->y1}};
+}
+
+/**
+ * @brief Renvoie le rectangle englobant de la région (taille nulle si elle est vide).
+ */
+ei_rect_t ei_region_extents(const ei_region_t* region){
+        const ei_region_box_t* box = &region->extents;
+        return (ei_rect_t){{box->x1, box->y1}, {box->x2 - box->x1, box->y2 - box->y1}};
+}
+
+/**
+ * @brief Construit la liste chaînée des rectangles de la région, par exemple pour
+ * \ref hw_surface_update_rects.
+ *
+ * @return la liste, à libérer par l'appelant, NULL si la région est vide.
+ */
+ei_linked_rect_t* ei_region_to_linked_rects(const ei_region_t* region){
+        ei_linked_rect_t* head = NULL;
+        for (int i = region->size - 1; i >= 0; i--){
+                ei_linked_rect_t* node = malloc(sizeof(ei_linked_rect_t));
+                node->rect = ei_region_rect(region, i);
+                node->next = head;
+                head = node;
+        }
+        return head;
+}
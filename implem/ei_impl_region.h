@@ -0,0 +1,110 @@
+/**
+ * @file	ei_impl_region.h
+ *
+ * @brief 	Régions : ensembles de pixels représentés, comme les régions X11, par des rectangles disjoints
+ *		rangés en bandes horizontales. Dans une bande, tous les rectangles ont les mêmes y, sont triés
+ *		par x et ne se touchent pas ; deux bandes successives qui se touchent ont des x différents
+ *		(sinon elles sont fusionnées). Cette forme canonique rend l'union, l'intersection et la
+ *		différence linéaires en nombre de rectangles.
+ */
+
+#ifndef PROJETC_IG_EI_IMPL_REGION_H
+#define PROJETC_IG_EI_IMPL_REGION_H
+
+#include <stdbool.h>
+#include "ei_types.h"
+
+/**
+ * @brief Un rectangle d'une région, en coordonnées de bords : [x1, x2[ x [y1, y2[.
+ */
+typedef struct ei_region_box_t {
+        int                     x1;
+        int                     y1;
+        int                     x2;
+        int                     y2;
+} ei_region_box_t;
+
+/**
+ * @brief Une région. Une région initialisée à zéro (ou par \ref ei_region_init) est vide et valide.
+ */
+typedef struct ei_region_t {
+        ei_region_box_t*        boxes;          ///< rectangles, par bandes de haut en bas puis par x
+        int                     size;           ///< nombre de rectangles
+        int                     capacity;       ///< taille allouée de boxes
+        ei_region_box_t         extents;        ///< rectangle englobant (vide si size == 0)
+} ei_region_t;
+
+/**
+ * @brief Initialise une région vide.
+ */
+void ei_region_init(ei_region_t* region);
+
+/**
+ * @brief Libère la mémoire d'une région, qui redevient vide.
+ */
+void ei_region_free(ei_region_t* region);
+
+/**
+ * @brief Vide une région en gardant sa mémoire.
+ */
+void ei_region_clear(ei_region_t* region);
+
+/**
+ * @return true si la région ne contient aucun pixel.
+ */
+bool ei_region_is_empty(const ei_region_t* region);
+
+/**
+ * @brief Remplace le contenu de region par le rectangle rect (vide si rect est vide).
+ */
+void ei_region_set_rect(ei_region_t* region, const ei_rect_t* rect);
+
+/**
+ * @brief result = a U b. result peut être a ou b.
+ */
+void ei_region_union(ei_region_t* result, const ei_region_t* a, const ei_region_t* b);
+
+/**
+ * @brief result = a inter b. result peut être a ou b.
+ */
+void ei_region_intersect(ei_region_t* result, const ei_region_t* a, const ei_region_t* b);
+
+/**
+ * @brief result = a \ b. result peut être a ou b.
+ */
+void ei_region_subtract(ei_region_t* result, const ei_region_t* a, const ei_region_t* b);
+
+/**
+ * @brief region = region U rect.
+ */
+void ei_region_union_rect(ei_region_t* region, const ei_rect_t* rect);
+
+/**
+ * @brief region = region inter rect.
+ */
+void ei_region_intersect_rect(ei_region_t* region, const ei_rect_t* rect);
+
+/**
+ * @brief region = region \ rect.
+ */
+void ei_region_subtract_rect(ei_region_t* region, const ei_rect_t* rect);
+
+/**
+ * @brief Renvoie le i-ème rectangle de la région (0 <= i < region->size) au format \ref ei_rect_t.
+ */
+ei_rect_t ei_region_rect(const ei_region_t* region, int i);
+
+/**
+ * @brief Renvoie le rectangle englobant de la région (taille nulle si elle est vide).
+ */
+ei_rect_t ei_region_extents(const ei_region_t* region);
+
+/**
+ * @brief Construit la liste chaînée des rectangles de la région, par exemple pour
+ * \ref hw_surface_update_rects.
+ *
+ * @return la liste, à libérer par l'appelant, NULL si la région est vide.
+ */
+ei_linked_rect_t* ei_region_to_linked_rects(const ei_region_t* region);
+
+#endif //PROJETC_IG_EI_IMPL_REGION_H
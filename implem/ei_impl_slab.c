@@ -0,0 +1,86 @@
+/**
+ * @file	ei_impl_slab.c
+ *
+ * @brief 	Implémentation des slabs : un bloc contient un en-tête (le lien vers le bloc suivant) puis
+ *		SLAB_OBJECTS objets, chacun arrondi à SLAB_ALIGN octets.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ei_impl_slab.h"
+
+#define SLAB_OBJECTS    64
+#define SLAB_ALIGN      16
+
+static ei_impl_slab_t* slabs = NULL;
+
+
+static size_t stride(const ei_impl_slab_t* slab){
+        size_t size = slab->object_size < sizeof(void*) ? sizeof(void*) : slab->object_size;
+        return (size + SLAB_ALIGN - 1) & ~(size_t)(SLAB_ALIGN - 1);
+}
+
+/*
+ * Ajoute un bloc à l'allocateur et chaîne ses objets dans la liste libre.
+ */
+static int grow(ei_impl_slab_t* slab){
+        size_t step = stride(slab);
+        char* block = malloc(SLAB_ALIGN + SLAB_OBJECTS * step);
+        if (!block) return 0;
+        *(void**)block = slab->blocks;
+        slab->blocks = block;
+        //chaînage à l'envers : les objets sont donnés dans l'ordre des adresses
+        for (int i = SLAB_OBJECTS - 1; i >= 0; i--){
+                void* object = block + SLAB_ALIGN + i * step;
+                *(void**)object = slab->free_list;
+                slab->free_list = object;
+        }
+        if (!slab->registered){
+                slab->registered = 1;
+                slab->next_slab = slabs;
+                slabs = slab;
+        }
+        return 1;
+}
+
+/**
+ * @brief Renvoie un objet mis à zéro (comme calloc).
+ */
+void* ei_impl_slab_alloc(ei_impl_slab_t* slab){
+        if (!slab->free_list && !grow(slab)) return NULL;
+        void* object = slab->free_list;
+        slab->free_list = *(void**)object;
+        slab->live++;
+        memset(object, 0, slab->object_size);
+        return object;
+}
+
+/**
+ * @brief Rend un objet obtenu par \ref ei_impl_slab_alloc sur le même allocateur (ptr peut être NULL).
+ */
+void ei_impl_slab_free(ei_impl_slab_t* slab, void* ptr){
+        if (!ptr) return;
+        *(void**)ptr = slab->free_list;
+        slab->free_list = ptr;
+        slab->live--;
+}
+
+/**
+ * @brief Rend tous les blocs de tous les allocateurs (appelée par \ref ei_app_free, une fois tous les
+ * widgets détruits) : les objets encore alloués deviennent invalides.
+ */
+void ei_impl_slab_free_all(void){
+        while (slabs){
+                ei_impl_slab_t* slab = slabs;
+                while (slab->blocks){
+                        void* next = *(void**)slab->blocks;
+                        free(slab->blocks);
+                        slab->blocks = next;
+                }
+                slab->free_list = NULL;
+                slab->live = 0;
+                slab->registered = 0;
+                slabs = slab->next_slab;
+                slab->next_slab = NULL;
+        }
+}
@@ -0,0 +1,47 @@
+/**
+ * @file	ei_impl_slab.h
+ *
+ * @brief 	Allocateurs par blocs (slabs) pour les objets de taille fixe créés en grand nombre : widgets des
+ *		classes prédéfinies et paramètres des gestionnaires de géométrie. Les objets sont découpés dans
+ *		de grands blocs et les objets libérés sont chaînés pour être réutilisés : créer ou détruire un
+ *		widget ne fait pas d'appel à malloc/free dans le cas courant, et les blocs sont rendus d'un coup
+ *		par \ref ei_impl_slab_free_all.
+ */
+
+#ifndef PROJETC_IG_EI_IMPL_SLAB_H
+#define PROJETC_IG_EI_IMPL_SLAB_H
+
+#include <stddef.h>
+
+/**
+ * @brief Un allocateur pour des objets de taille object_size. S'initialise statiquement avec
+ * \ref EI_IMPL_SLAB_INIT, aucune allocation n'est faite avant le premier objet.
+ */
+typedef struct ei_impl_slab_t {
+        size_t                  object_size;    ///< taille demandée
+        void*                   free_list;      ///< objets libres, chaînés par leur premier mot
+        void*                   blocks;         ///< blocs alloués, chaînés par leur premier mot
+        int                     live;           ///< nombre d'objets alloués et pas encore libérés
+        struct ei_impl_slab_t*  next_slab;      ///< allocateurs déjà utilisés (pour ei_impl_slab_free_all)
+        int                     registered;
+} ei_impl_slab_t;
+
+#define EI_IMPL_SLAB_INIT(size) { (size), NULL, NULL, 0, NULL, 0 }
+
+/**
+ * @brief Renvoie un objet mis à zéro (comme calloc).
+ */
+void* ei_impl_slab_alloc(ei_impl_slab_t* slab);
+
+/**
+ * @brief Rend un objet obtenu par \ref ei_impl_slab_alloc sur le même allocateur (ptr peut être NULL).
+ */
+void ei_impl_slab_free(ei_impl_slab_t* slab, void* ptr);
+
+/**
+ * @brief Rend tous les blocs de tous les allocateurs (appelée par \ref ei_app_free, une fois tous les
+ * widgets détruits) : les objets encore alloués deviennent invalides.
+ */
+void ei_impl_slab_free_all(void);
+
+#endif //PROJETC_IG_EI_IMPL_SLAB_H
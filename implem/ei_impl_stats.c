@@ -0,0 +1,121 @@
+/**
+ * @file	ei_impl_stats.c
+ *
+ * @brief 	Profiler intégré : échantillons des phases et compteurs.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ei_impl_stats.h"
+
+/**
+ * @brief Les échantillons d'une phase.
+ */
+typedef struct {
+        uint64_t        count;
+        double          total;
+        double          max;
+        double          window[EI_IMPL_STATS_WINDOW];   ///< derniers échantillons (tampon circulaire)
+} ei_impl_stats_phase_t;
+
+bool                            ei_impl_stats_enabled   = false;
+uint64_t                        ei_impl_stats_counters[ei_stats_nb_counters];
+static ei_impl_stats_phase_t    phases[ei_stats_nb_phases];
+static bool                     dump_on_exit            = false;
+
+static const char* phase_names[ei_stats_nb_phases] = {
+        "wait", "dispatch", "callback", "animation", "layout", "draw", "present", "frame"
+};
+static const char* counter_names[ei_stats_nb_counters] = {
+        "events", "frames", "widgets drawn", "polygons", "pixels blended", "rects presented"
+};
+
+
+/**
+ * @brief Enregistre un échantillon de la phase (la durée écoulée depuis start).
+ */
+void ei_impl_stats_record(ei_stats_phase_t phase, double start){
+        double sample = ei_impl_stats_now() - start;
+        ei_impl_stats_phase_t* p = &phases[phase];
+        p->window[p->count % EI_IMPL_STATS_WINDOW] = sample;
+        p->count++;
+        p->total += sample;
+        if (sample > p->max) p->max = sample;
+}
+
+static int compare_samples(const void* a, const void* b){
+        double x = *(const double*)a, y = *(const double*)b;
+        return (x > y) - (x < y);
+}
+
+/*
+ * Percentile q des n échantillons triés.
+ */
+static double percentile(const double* sorted, int n, double q){
+        int i = (int)(q * n + 0.999999) - 1;
+        return sorted[i < 0 ? 0 : (i >= n ? n - 1 : i)];
+}
+
+/**
+ * @brief Calcule le résumé d'une phase (les percentiles sur la fenêtre des derniers échantillons).
+ */
+bool ei_impl_stats_summary(ei_stats_phase_t phase, ei_stats_summary_t* summary){
+        memset(summary, 0, sizeof(*summary));
+        if (phase < 0 || phase >= ei_stats_nb_phases || phases[phase].count == 0) return false;
+        ei_impl_stats_phase_t* p = &phases[phase];
+        int n = p->count < EI_IMPL_STATS_WINDOW ? (int)p->count : EI_IMPL_STATS_WINDOW;
+        double sorted[EI_IMPL_STATS_WINDOW];
+        memcpy(sorted, p->window, n * sizeof(double));
+        qsort(sorted, n, sizeof(double), compare_samples);
+        summary->count = p->count;
+        summary->total = p->total;
+        summary->max = p->max;
+        summary->p50 = percentile(sorted, n, 0.50);
+        summary->p95 = percentile(sorted, n, 0.95);
+        summary->p99 = percentile(sorted, n, 0.99);
+        return true;
+}
+
+/**
+ * @brief Oublie les échantillons et remet les compteurs à 0.
+ */
+void ei_impl_stats_reset(void){
+        memset(phases, 0, sizeof(phases));
+        memset(ei_impl_stats_counters, 0, sizeof(ei_impl_stats_counters));
+}
+
+/**
+ * @brief Affiche le rapport des phases (en millisecondes) et des compteurs.
+ */
+void ei_impl_stats_dump(FILE* file){
+        fprintf(file, "%-10s %10s %12s %9s %9s %9s %9s\n", "phase", "count", "total(ms)", "p50(ms)", "p95(ms)",
+                "p99(ms)", "max(ms)");
+        for (int phase = 0; phase < ei_stats_nb_phases; phase++){
+                ei_stats_summary_t s;
+                if (!ei_impl_stats_summary(phase, &s)) continue;
+                fprintf(file, "%-10s %10llu %12.3f %9.3f %9.3f %9.3f %9.3f\n", phase_names[phase],
+                        (unsigned long long)s.count, s.total * 1000, s.p50 * 1000, s.p95 * 1000, s.p99 * 1000,
+                        s.max * 1000);
+        }
+        for (int counter = 0; counter < ei_stats_nb_counters; counter++)
+                fprintf(file, "%-16s %llu\n", counter_names[counter],
+                        (unsigned long long)ei_impl_stats_counters[counter]);
+}
+
+/**
+ * @brief Active le profiler si la variable d'environnement EI_STATS est définie (appelée par \ref ei_app_create).
+ */
+void ei_impl_stats_init(void){
+        const char* env = getenv("EI_STATS");
+        dump_on_exit = env && strcmp(env, "0") != 0;
+        ei_impl_stats_enabled = dump_on_exit;
+        ei_impl_stats_reset();
+}
+
+/**
+ * @brief Affiche le rapport sur la sortie d'erreur si EI_STATS est définie (appelée par \ref ei_app_free).
+ */
+void ei_impl_stats_exit(void){
+        if (dump_on_exit) ei_impl_stats_dump(stderr);
+        ei_impl_stats_enabled = false;
+}
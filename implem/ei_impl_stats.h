@@ -0,0 +1,85 @@
+/**
+ * @file	ei_impl_stats.h
+ *
+ * @brief 	Profiler intégré : chaque phase de \ref ei_app_run est chronométrée (si le
+ *		profiler est activé) et ses derniers échantillons sont gardés dans un tampon circulaire pour
+ *		les percentiles. Les compteurs de dessin sont de simples additions, toujours actives.
+ */
+
+#ifndef PROJETC_IG_EI_IMPL_STATS_H
+#define PROJETC_IG_EI_IMPL_STATS_H
+
+#include <time.h>
+#include "ei_stats.h"
+#include "hw_interface.h"
+
+/**
+ * @brief Nombre d'échantillons gardés par phase pour les percentiles.
+ */
+#define EI_IMPL_STATS_WINDOW 1024
+
+extern bool     ei_impl_stats_enabled;
+extern uint64_t ei_impl_stats_counters[ei_stats_nb_counters];
+
+/**
+ * @brief Ajoute n au compteur.
+ */
+static inline void ei_impl_stats_count(ei_stats_counter_t counter, uint64_t n){
+        ei_impl_stats_counters[counter] += n;
+}
+
+/**
+ * @brief Horloge du profiler, en secondes : une horloge monotone du système plutôt que \ref hw_now, qui peut
+ * être virtuelle (hw_headless.c) alors que les durées mesurées doivent être réelles.
+ */
+static inline double ei_impl_stats_now(void){
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Début d'une phase : renvoie la date à donner à \ref ei_impl_stats_end (0 si le profiler est désactivé).
+ */
+static inline double ei_impl_stats_begin(void){
+        return ei_impl_stats_enabled ? ei_impl_stats_now() : 0;
+}
+
+/**
+ * @brief Enregistre un échantillon de la phase (la durée écoulée depuis start).
+ */
+void ei_impl_stats_record(ei_stats_phase_t phase, double start);
+
+/**
+ * @brief Fin d'une phase commencée par \ref ei_impl_stats_begin.
+ */
+static inline void ei_impl_stats_end(ei_stats_phase_t phase, double start){
+        if (ei_impl_stats_enabled) ei_impl_stats_record(phase, start);
+}
+
+/**
+ * @brief Calcule le résumé d'une phase (les percentiles sur la fenêtre des derniers échantillons).
+ */
+bool ei_impl_stats_summary(ei_stats_phase_t phase, ei_stats_summary_t* summary);
+
+/**
+ * @brief Oublie les échantillons et remet les compteurs à 0.
+ */
+void ei_impl_stats_reset(void);
+
+/**
+ * @brief Affiche le rapport des phases (en millisecondes) et des compteurs.
+ */
+void ei_impl_stats_dump(FILE* file);
+
+/**
+ * @brief Active le profiler si la variable d'environnement EI_STATS est définie (appelée par \ref ei_app_create).
+ */
+void ei_impl_stats_init(void);
+
+/**
+ * @brief Affiche le rapport sur la sortie d'erreur si EI_STATS est définie (appelée par \ref ei_app_free).
+ */
+void ei_impl_stats_exit(void);
+
+#endif //PROJETC_IG_EI_IMPL_STATS_H
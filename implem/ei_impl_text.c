@@ -0,0 +1,309 @@
+/**
+ * @file	ei_impl_text.c
+ *
+ * @brief 	Atlas de glyphes. Une police a un atlas : un plan de couverture 8 bits de ATLAS_WIDTH colonnes,
+ *		rempli par étagères de la hauteur de ligne de la police (tous les glyphes rendus par
+ *		\ref hw_text_create_surface ont cette hauteur). Les glyphes ASCII sont indexés directement,
+ *		les autres sont dans une liste chaînée.
+ *
+ *		Le texte est composé glyphe par glyphe, en avançant de la largeur de chaque glyphe : le
+ *		crénage entre deux caractères n'est donc pas appliqué.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ei_impl_text.h"
+#include "ei_impl_blend.h"
+#include "ei_implementation.h"
+
+#define ATLAS_WIDTH     1024
+#define ASCII_GLYPHS    128
+
+
+/**
+ * @brief Un glyphe rasterisé : sa place dans le plan de couverture de l'atlas et son avance.
+ */
+typedef struct ei_impl_glyph_t {
+        uint32_t                        codepoint;
+        int                             x;              ///< colonne du glyphe dans le plan de couverture
+        int                             y;              ///< première ligne de l'étagère du glyphe
+        int                             width;          ///< largeur du masque et avance, -1 si pas encore rasterisé
+        struct ei_impl_glyph_t*         next;           ///< glyphe hors ASCII suivant
+} ei_impl_glyph_t;
+
+
+/**
+ * @brief L'atlas d'une police.
+ */
+typedef struct ei_impl_atlas_t {
+        ei_font_t                       font;
+        int                             height;         ///< hauteur de ligne de la police (hauteur des étagères)
+        uint8_t*                        coverage;       ///< plan de couverture, ATLAS_WIDTH octets par ligne
+        int                             rows;           ///< nombre de lignes allouées du plan
+        int                             pen_x;          ///< prochaine colonne libre de l'étagère courante
+        int                             pen_y;          ///< première ligne de l'étagère courante
+        ei_impl_glyph_t                 ascii[ASCII_GLYPHS];
+        ei_impl_glyph_t*                others;
+        struct ei_impl_atlas_t*         next;
+} ei_impl_atlas_t;
+
+static ei_impl_atlas_t* atlases = NULL;
+
+
+/*
+ * Décode le caractère UTF-8 en tête de *text et avance *text. Un octet invalide est pris tel quel.
+ */
+static uint32_t next_codepoint(const char** text){
+        const unsigned char* s = (const unsigned char*)*text;
+        int length;
+        uint32_t codepoint;
+
+        if (s[0] < 0x80)                { codepoint = s[0];        length = 1; }
+        else if ((s[0] & 0xE0) == 0xC0) { codepoint = s[0] & 0x1F; length = 2; }
+        else if ((s[0] & 0xF0) == 0xE0) { codepoint = s[0] & 0x0F; length = 3; }
+        else if ((s[0] & 0xF8) == 0xF0) { codepoint = s[0] & 0x07; length = 4; }
+        else                            { *text += 1; return s[0]; }
+
+        for (int i = 1; i < length; i++){
+                if ((s[i] & 0xC0) != 0x80){
+                        *text += 1;
+                        return s[0];
+                }
+                codepoint = (codepoint << 6) | (s[i] & 0x3F);
+        }
+        *text += length;
+        return codepoint;
+}
+
+/*
+ * Ecrit le caractère en UTF-8 (terminé par '\0') dans buffer, qui doit faire au moins 5 octets.
+ */
+static void encode_codepoint(uint32_t codepoint, char* buffer){
+        unsigned char* b = (unsigned char*)buffer;
+        if (codepoint < 0x80){
+                b[0] = codepoint; b[1] = 0;
+        } else if (codepoint < 0x800){
+                b[0] = 0xC0 | (codepoint >> 6);  b[1] = 0x80 | (codepoint & 0x3F); b[2] = 0;
+        } else if (codepoint < 0x10000){
+                b[0] = 0xE0 | (codepoint >> 12); b[1] = 0x80 | ((codepoint >> 6) & 0x3F);
+                b[2] = 0x80 | (codepoint & 0x3F); b[3] = 0;
+        } else {
+                b[0] = 0xF0 | (codepoint >> 18); b[1] = 0x80 | ((codepoint >> 12) & 0x3F);
+                b[2] = 0x80 | ((codepoint >> 6) & 0x3F); b[3] = 0x80 | (codepoint & 0x3F); b[4] = 0;
+        }
+}
+
+/*
+ * Renvoie l'atlas de la police, créé vide au premier appel. L'atlas trouvé est remis en tête de liste.
+ */
+static ei_impl_atlas_t* get_atlas(ei_font_t font){
+        ei_impl_atlas_t* previous = NULL;
+        for (ei_impl_atlas_t* atlas = atlases; atlas; previous = atlas, atlas = atlas->next){
+                if (atlas->font != font) continue;
+                if (previous){
+                        previous->next = atlas->next;
+                        atlas->next = atlases;
+                        atlases = atlas;
+                }
+                return atlas;
+        }
+
+        int width;
+        ei_impl_atlas_t* atlas = calloc(1, sizeof(ei_impl_atlas_t));
+        atlas->font = font;
+        hw_text_compute_size("X", font, &width, &atlas->height);
+        for (int i = 0; i < ASCII_GLYPHS; i++){
+                atlas->ascii[i].codepoint = i;
+                atlas->ascii[i].width = -1;
+        }
+        atlas->next = atlases;
+        atlases = atlas;
+        return atlas;
+}
+
+/*
+ * Réserve la place d'un glyphe de largeur width dans le plan de couverture (étagère suivante si la
+ * courante est pleine, plan agrandi si besoin).
+ */
+static void reserve_glyph(ei_impl_atlas_t* atlas, ei_impl_glyph_t* glyph, int width){
+        if (atlas->pen_x + width > ATLAS_WIDTH){
+                atlas->pen_x = 0;
+                atlas->pen_y += atlas->height;
+        }
+        if (atlas->pen_y + atlas->height > atlas->rows){
+                int rows = atlas->rows ? 2 * atlas->rows : 4 * atlas->height;
+                while (atlas->pen_y + atlas->height > rows) rows *= 2;
+                atlas->coverage = realloc(atlas->coverage, (size_t)rows * ATLAS_WIDTH);
+                memset(atlas->coverage + (size_t)atlas->rows * ATLAS_WIDTH, 0, (size_t)(rows - atlas->rows) * ATLAS_WIDTH);
+                atlas->rows = rows;
+        }
+        glyph->x = atlas->pen_x;
+        glyph->y = atlas->pen_y;
+        glyph->width = width;
+        atlas->pen_x += width;
+}
+
+/*
+ * Rasterise le glyphe une fois, en blanc, et range sa couverture (canal alpha de la surface de texte)
+ * dans l'atlas.
+ */
+static void rasterize_glyph(ei_impl_atlas_t* atlas, ei_impl_glyph_t* glyph){
+        char            utf8[5];
+        int             ir, ig, ib, ia;
+
+        encode_codepoint(glyph->codepoint, utf8);
+        ei_surface_t text = hw_text_create_surface(utf8, atlas->font, (ei_color_t){0xFF, 0xFF, 0xFF, 0xFF});
+        if (!text){
+                reserve_glyph(atlas, glyph, 0);
+                return;
+        }
+        ei_size_t size = hw_surface_get_size(text);
+        int width = size.width < ATLAS_WIDTH ? size.width : ATLAS_WIDTH;
+        int height = size.height < atlas->height ? size.height : atlas->height;
+        reserve_glyph(atlas, glyph, width);
+
+        hw_surface_lock(text);
+        hw_surface_get_channel_indices(text, &ir, &ig, &ib, &ia);
+        const uint32_t* pixels = (const uint32_t*)hw_surface_get_buffer(text);
+        for (int y = 0; y < height; y++){
+                uint8_t* row = atlas->coverage + (size_t)(glyph->y + y) * ATLAS_WIDTH + glyph->x;
+                for (int x = 0; x < width; x++){
+                        uint32_t p = pixels[(size_t)y * size.width + x];
+                        if (ia >= 0){
+                                row[x] = (p >> (8 * ia)) & 0xFF;
+                        } else {
+                                //pas de canal alpha : du blanc sur noir, la couverture est l'intensité
+                                uint8_t r = (p >> (8 * ir)) & 0xFF, g = (p >> (8 * ig)) & 0xFF, b = (p >> (8 * ib)) & 0xFF;
+                                row[x] = r > g ? (r > b ? r : b) : (g > b ? g : b);
+                        }
+                }
+        }
+        hw_surface_unlock(text);
+        hw_surface_free(text);
+}
+
+/*
+ * Renvoie le glyphe du caractère, rasterisé au premier appel.
+ */
+static ei_impl_glyph_t* get_glyph(ei_impl_atlas_t* atlas, uint32_t codepoint){
+        ei_impl_glyph_t* glyph;
+        if (codepoint < ASCII_GLYPHS){
+                glyph = &atlas->ascii[codepoint];
+        } else {
+                for (glyph = atlas->others; glyph; glyph = glyph->next)
+                        if (glyph->codepoint == codepoint) return glyph;
+                glyph = calloc(1, sizeof(ei_impl_glyph_t));
+                glyph->codepoint = codepoint;
+                glyph->width = -1;
+                glyph->next = atlas->others;
+                atlas->others = glyph;
+        }
+        if (glyph->width < 0) rasterize_glyph(atlas, glyph);
+        return glyph;
+}
+
+/**
+ * @brief Calcule la taille du texte tel que le compose \ref ei_impl_text_draw (somme des avances des glyphes,
+ * hauteur de ligne de la police). A utiliser pour placer le texte, à la place d'une surface temporaire.
+ *
+ * @param text          le texte (UTF-8)
+ * @param font          la police
+ * @return la taille du texte.
+ */
+ei_size_t ei_impl_text_size(ei_const_string_t text, ei_font_t font){
+        ei_impl_atlas_t* atlas = get_atlas(font);
+        ei_size_t size = {0, atlas->height};
+        while (text && *text)
+                size.width += get_glyph(atlas, next_codepoint(&text))->width;
+        return size;
+}
+
+/**
+ * @brief Compose le texte dans surface à partir de l'atlas de la police (rasterise les glyphes manquants).
+ *
+ * @param surface       surface verrouillée où dessiner
+ * @param where         coin haut gauche du texte
+ * @param text          le texte (UTF-8)
+ * @param font          la police
+ * @param color         la couleur du texte, l'alpha n'est pas utilisé (comme \ref hw_text_create_surface)
+ * @param clipper       si non NULL, le dessin est restreint à ce rectangle
+ */
+void ei_impl_text_draw(ei_surface_t surface,
+                       ei_point_t where,
+                       ei_const_string_t text,
+                       ei_font_t font,
+                       ei_color_t color,
+                       const ei_rect_t* clipper){
+        int             ir, ig, ib, ia;
+        ei_size_t       size = hw_surface_get_size(surface);
+        ei_rect_t       clip = {{0, 0}, size};
+
+        if (!text) return;
+        if (clipper) clip = get_rect_intersection(clip, *clipper);
+        int clip_x1 = clip.top_left.x + clip.size.width;
+        int clip_y1 = clip.top_left.y + clip.size.height;
+
+        ei_impl_atlas_t* atlas = get_atlas(font);
+        int y0 = where.y > clip.top_left.y ? where.y : clip.top_left.y;
+        int y1 = where.y + atlas->height < clip_y1 ? where.y + atlas->height : clip_y1;
+
+        hw_surface_get_channel_indices(surface, &ir, &ig, &ib, &ia);
+        uint32_t pixel = ei_impl_map_rgba(surface, color);
+        uint32_t opaque = ia >= 0 ? (uint32_t)0xFF << (8 * ia) : 0;
+        uint32_t* pixels = (uint32_t*)hw_surface_get_buffer(surface);
+
+        int pen = where.x;
+        while (*text && pen < clip_x1){
+                ei_impl_glyph_t* glyph = get_glyph(atlas, next_codepoint(&text));
+                int x0 = pen > clip.top_left.x ? pen : clip.top_left.x;
+                int x1 = pen + glyph->width < clip_x1 ? pen + glyph->width : clip_x1;
+                if (x0 < x1 && y0 < y1){
+                        ei_impl_blend_mask_rows(pixels + (size_t)y0 * size.width + x0, size.width,
+                                                atlas->coverage + (size_t)(glyph->y + y0 - where.y) * ATLAS_WIDTH
+                                                                + glyph->x + x0 - pen,
+                                                ATLAS_WIDTH, x1 - x0, y1 - y0, pixel, opaque);
+                }
+                pen += glyph->width;
+        }
+}
+
+static void free_atlas(ei_impl_atlas_t* atlas){
+        ei_impl_glyph_t* glyph = atlas->others;
+        while (glyph){
+                ei_impl_glyph_t* next = glyph->next;
+                free(glyph);
+                glyph = next;
+        }
+        free(atlas->coverage);
+        free(atlas);
+}
+
+/**
+ * @brief Oublie l'atlas d'une police. A appeler avant \ref hw_text_font_free, sinon une nouvelle police
+ * allouée à la même adresse réutiliserait les glyphes de l'ancienne.
+ *
+ * @param font          la police qui va être libérée
+ */
+void ei_impl_text_forget_font(ei_font_t font){
+        ei_impl_atlas_t** link = &atlases;
+        while (*link){
+                if ((*link)->font == font){
+                        ei_impl_atlas_t* atlas = *link;
+                        *link = atlas->next;
+                        free_atlas(atlas);
+                        return;
+                }
+                link = &(*link)->next;
+        }
+}
+
+/**
+ * @brief Libère tous les atlas (appelée par \ref ei_app_free).
+ */
+void ei_impl_text_free(void){
+        while (atlases){
+                ei_impl_atlas_t* next = atlases->next;
+                free_atlas(atlases);
+                atlases = next;
+        }
+}
@@ -0,0 +1,56 @@
+/**
+ * @file	ei_impl_text.h
+ *
+ * @brief 	Rendu du texte par atlas de glyphes : chaque glyphe d'une police est rasterisé une seule fois
+ *		par \ref hw_text_create_surface, sa couverture est rangée dans le plan de couverture de l'atlas
+ *		de la police, puis le texte est composé en mélangeant les glyphes dans la couleur demandée.
+ *		Aucune surface n'est donc allouée pour redessiner un texte déjà rencontré.
+ */
+
+#ifndef PROJETC_IG_EI_IMPL_TEXT_H
+#define PROJETC_IG_EI_IMPL_TEXT_H
+
+#include "ei_types.h"
+#include "hw_interface.h"
+
+/**
+ * @brief Calcule la taille du texte tel que le compose \ref ei_impl_text_draw (somme des avances des glyphes,
+ * hauteur de ligne de la police). A utiliser pour placer le texte, à la place d'une surface temporaire.
+ *
+ * @param text          le texte (UTF-8)
+ * @param font          la police
+ * @return la taille du texte.
+ */
+ei_size_t ei_impl_text_size(ei_const_string_t text, ei_font_t font);
+
+/**
+ * @brief Compose le texte dans surface à partir de l'atlas de la police (rasterise les glyphes manquants).
+ *
+ * @param surface       surface verrouillée où dessiner
+ * @param where         coin haut gauche du texte
+ * @param text          le texte (UTF-8)
+ * @param font          la police
+ * @param color         la couleur du texte, l'alpha n'est pas utilisé (comme \ref hw_text_create_surface)
+ * @param clipper       si non NULL, le dessin est restreint à ce rectangle
+ */
+void ei_impl_text_draw(ei_surface_t surface,
+                       ei_point_t where,
+                       ei_const_string_t text,
+                       ei_font_t font,
+                       ei_color_t color,
+                       const ei_rect_t* clipper);
+
+/**
+ * @brief Oublie l'atlas d'une police. A appeler avant \ref hw_text_font_free, sinon une nouvelle police
+ * allouée à la même adresse réutiliserait les glyphes de l'ancienne.
+ *
+ * @param font          la police qui va être libérée
+ */
+void ei_impl_text_forget_font(ei_font_t font);
+
+/**
+ * @brief Libère tous les atlas (appelée par \ref ei_app_free).
+ */
+void ei_impl_text_free(void);
+
+#endif //PROJETC_IG_EI_IMPL_TEXT_H
@@ -0,0 +1,167 @@
+/**
+ * @file	ei_impl_timer.c
+ *
+ * @brief 	Service de timers : tas binaire des timers par échéance, un seul réveil programmé.
+ */
+
+#include <stdlib.h>
+#include "ei_impl_timer.h"
+#include "ei_impl_slab.h"
+#include "ei_impl_stats.h"
+#include "hw_interface.h"
+
+/*
+ * Marge sur les échéances : un réveil arrondi à la milliseconde peut arriver un peu avant l'échéance.
+ * Les délais sont d'au moins 1 ms, donc un timer (re)lancé depuis un callback n'est jamais échu dans la
+ * même passe.
+ */
+#define TIMER_SLACK     0.0005
+
+static ei_impl_slab_t   timer_slab      = EI_IMPL_SLAB_INIT(sizeof(ei_impl_timer_t));
+static ei_impl_timer_t** heap           = NULL;
+static int              nb_timers       = 0;
+static int              capacity        = 0;
+static void*            wakeup          = NULL;  ///< réveil programmé, NULL s'il n'y en a pas
+static double           wakeup_deadline = 0;     ///< échéance pour laquelle il a été programmé
+static int              timer_tag;               ///< son adresse identifie le réveil des timers
+static bool             in_event        = false; ///< pendant ei_impl_timer_event : réveil reprogrammé à la fin
+static ei_impl_timer_t* firing          = NULL;  ///< timer dont le callback est en cours
+
+static void swap(int i, int j){
+        ei_impl_timer_t* t = heap[i];
+        heap[i] = heap[j];
+        heap[j] = t;
+        heap[i]->index = i;
+        heap[j]->index = j;
+}
+
+static void sift_up(int i){
+        while (i > 0 && heap[(i-1)/2]->deadline > heap[i]->deadline){
+                swap(i, (i-1)/2);
+                i = (i-1)/2;
+        }
+}
+
+static void sift_down(int i){
+        for (;;){
+                int min = i, l = 2*i+1, r = 2*i+2;
+                if (l < nb_timers && heap[l]->deadline < heap[min]->deadline) min = l;
+                if (r < nb_timers && heap[r]->deadline < heap[min]->deadline) min = r;
+                if (min == i) return;
+                swap(i, min);
+                i = min;
+        }
+}
+
+static void heap_push(ei_impl_timer_t* timer){
+        if (nb_timers == capacity){
+                capacity = capacity ? 2*capacity : 64;
+                heap = realloc(heap, capacity * sizeof(ei_impl_timer_t*));
+        }
+        timer->index = nb_timers;
+        heap[nb_timers++] = timer;
+        sift_up(timer->index);
+}
+
+static void heap_remove(ei_impl_timer_t* timer){
+        int i = timer->index;
+        timer->index = -1;
+        if (--nb_timers == i) return;
+        heap[i] = heap[nb_timers];
+        heap[i]->index = i;
+        sift_up(i);
+        sift_down(heap[i]->index);
+}
+
+/*
+ * Programme le réveil pour l'échéance la plus proche, s'il ne l'est pas déjà.
+ */
+static void rearm(void){
+        if (in_event) return;
+        if (nb_timers == 0){
+                if (wakeup) hw_event_cancel_app(wakeup);
+                wakeup = NULL;
+                return;
+        }
+        double deadline = heap[0]->deadline;
+        if (wakeup && wakeup_deadline == deadline) return;
+        if (wakeup) hw_event_cancel_app(wakeup);
+        int ms = (int)((deadline - hw_now()) * 1000.0 + 0.999);
+        wakeup = hw_event_schedule_app(ms < 1 ? 1 : ms, &timer_tag);
+        wakeup_deadline = deadline;
+}
+
+/**
+ * @brief Crée un timer et le met dans le tas. Un timer répétitif si period_ms > 0.
+ */
+ei_impl_timer_t* ei_impl_timer_new(int delay_ms, int period_ms, ei_timer_callback_t callback, ei_user_param_t user_param){
+        ei_impl_timer_t* timer = ei_impl_slab_alloc(&timer_slab);
+        timer->deadline = hw_now() + (delay_ms < 1 ? 1 : delay_ms) / 1000.0;
+        timer->period = period_ms > 0 ? period_ms / 1000.0 : 0;
+        timer->callback = callback;
+        timer->user_param = user_param;
+        heap_push(timer);
+        rearm();
+        return timer;
+}
+
+/**
+ * @brief Retire un timer du tas et le libère (ou le marque, si c'est son callback qui est en cours).
+ */
+void ei_impl_timer_remove(ei_impl_timer_t* timer){
+        if (!timer) return;
+        if (timer == firing){
+                timer->cancelled = true;
+                return;
+        }
+        if (timer->index >= 0) heap_remove(timer);
+        ei_impl_slab_free(&timer_slab, timer);
+        rearm();
+}
+
+/**
+ * @brief Traite le réveil des timers : appelle les callbacks des timers échus et reprogramme le réveil.
+ *
+ * @param event un évènement renvoyé par \ref hw_event_wait_next
+ *
+ * @return true si l'évènement était le réveil des timers (il ne doit pas être passé aux binds).
+ */
+bool ei_impl_timer_event(ei_event_t* event){
+        if (event->type != ei_ev_app || event->param.application.user_param != &timer_tag) return false;
+        wakeup = NULL;
+        in_event = true;
+        double now = hw_now();
+        while (nb_timers > 0 && heap[0]->deadline <= now + TIMER_SLACK){
+                ei_impl_timer_t* timer = heap[0];
+                heap_remove(timer);
+                firing = timer;
+                double start = ei_impl_stats_begin();
+                timer->callback(timer, timer->user_param);
+                ei_impl_stats_end(ei_stats_callback, start);
+                firing = NULL;
+                if (timer->period > 0 && !timer->cancelled){
+                        //les périodes manquées sont sautées : la prochaine échéance est dans le futur
+                        double late = now - timer->deadline;
+                        int skipped = late > 0 ? (int)(late / timer->period) : 0;
+                        timer->deadline += (skipped + 1) * timer->period;
+                        heap_push(timer);
+                } else {
+                        ei_impl_slab_free(&timer_slab, timer);
+                }
+        }
+        in_event = false;
+        rearm();
+        return true;
+}
+
+/**
+ * @brief Annule le réveil et libère tous les timers (appelée par \ref ei_app_free).
+ */
+void ei_impl_timer_free(void){
+        if (wakeup) hw_event_cancel_app(wakeup);
+        wakeup = NULL;
+        for (int i = 0; i < nb_timers; i++) ei_impl_slab_free(&timer_slab, heap[i]);
+        free(heap);
+        heap = NULL;
+        nb_timers = capacity = 0;
+}
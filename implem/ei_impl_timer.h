@@ -0,0 +1,52 @@
+/**
+ * @file	ei_impl_timer.h
+ *
+ * @brief 	Service de timers : un tas binaire (min-heap) des timers par échéance, et un seul réveil
+ *		\ref hw_event_schedule_app programmé pour l'échéance la plus proche. Le réveil est intercepté
+ *		par la boucle principale avant les binds, et les timers échus appellent directement leur callback.
+ */
+
+#ifndef PROJETC_IG_EI_IMPL_TIMER_H
+#define PROJETC_IG_EI_IMPL_TIMER_H
+
+#include <stdbool.h>
+#include "ei_timer.h"
+#include "ei_event.h"
+
+/**
+ * @brief Un timer.
+ */
+typedef struct ei_impl_timer_t {
+        double                  deadline;       ///< échéance (secondes, horloge de \ref hw_now)
+        double                  period;         ///< 0 pour un timer à un coup
+        ei_timer_callback_t     callback;
+        ei_user_param_t         user_param;
+        int                     index;          ///< place dans le tas, -1 s'il n'y est pas
+        bool                    cancelled;      ///< annulé pendant son propre callback
+} ei_impl_timer_t;
+
+/**
+ * @brief Crée un timer et le met dans le tas. Un timer répétitif si period_ms > 0.
+ */
+ei_impl_timer_t* ei_impl_timer_new(int delay_ms, int period_ms, ei_timer_callback_t callback, ei_user_param_t user_param);
+
+/**
+ * @brief Retire un timer du tas et le libère (ou le marque, si c'est son callback qui est en cours).
+ */
+void ei_impl_timer_remove(ei_impl_timer_t* timer);
+
+/**
+ * @brief Traite le réveil des timers : appelle les callbacks des timers échus et reprogramme le réveil.
+ *
+ * @param event un évènement renvoyé par \ref hw_event_wait_next
+ *
+ * @return true si l'évènement était le réveil des timers (il ne doit pas être passé aux binds).
+ */
+bool ei_impl_timer_event(ei_event_t* event);
+
+/**
+ * @brief Annule le réveil et libère tous les timers (appelée par \ref ei_app_free).
+ */
+void ei_impl_timer_free(void);
+
+#endif //PROJETC_IG_EI_IMPL_TIMER_H
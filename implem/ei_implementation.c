@@ -7,6 +7,11 @@
 
 #include <ei_widget_configure.h>
 #include "ei_implementation.h"
+#include "ei_impl_region.h"
+#include "ei_impl_raster.h"
+#include "ei_impl_atom.h"
+#include "ei_impl_slab.h"
+#include "ei_impl_stats.h"
 #include "ei_draw.h"
 #include "ei_event.h"
 #include "var.h"
@@ -14,6 +19,10 @@
 #include "ei_types.h"
 
 ei_widget_t current_button_down = NULL;
+
+//slabs des widgets frame et button
+static ei_impl_slab_t frame_slab  = EI_IMPL_SLAB_INIT(sizeof(ei_impl_frame_t));
+static ei_impl_slab_t button_slab = EI_IMPL_SLAB_INIT(sizeof(ei_impl_button_t));
 /**
  * @brief	Draws the children of a widget.
  * 		The children are draw withing the limits of the clipper and
@@ -31,21 +40,52 @@ void		ei_impl_widget_draw_children	(ei_widget_t		widget,
 						 ei_rect_t*		clipper){
         if (widget!=ei_app_root_widget() && (! widget->geom_params || ! widget->geom_params->manager)) return;
         (widget->wclass->drawfunc)(widget,surface,pick_surface,clipper);
-
-        ei_widget_t child = widget->children_head;
-        ei_rect_t new_clipper;
-        if (child) {
-                new_clipper = get_rect_intersection(*clipper, child->screen_location);
-        }
-        while (child){
-                if (new_clipper.size.width != 0 && new_clipper.size.height != 0) {
-                        ei_impl_widget_draw_children(child, surface, pick_surface, &new_clipper);
+        ei_impl_stats_count(ei_stats_widgets_drawn, 1);
+
+        int nb_children = 0;
+        for (ei_widget_t child = widget->children_head; child; child = child->next_sibling) nb_children++;
+        if (nb_children == 0) return;
+
+        ei_widget_t children_buffer[32];
+        ei_rect_t clippers_buffer[32];
+        ei_widget_t* children = nb_children <= 32 ? children_buffer : malloc(nb_children * sizeof(ei_widget_t));
+        ei_rect_t* clippers = nb_children <= 32 ? clippers_buffer : malloc(nb_children * sizeof(ei_rect_t));
+        int i = 0;
+        for (ei_widget_t child = widget->children_head; child; child = child->next_sibling) children[i++] = child;
+
+        //passe d'occlusion, du dernier enfant (dessiné au dessus) au premier : on retire de la zone visible de
+        //chaque enfant les parties opaques des frères dessinés après lui
+        ei_region_t occluders;
+        ei_region_t visible;
+        ei_region_init(&occluders);
+        ei_region_init(&visible);
+        for (i = nb_children - 1; i >= 0; i--){
+                ei_widget_t child = children[i];
+                ei_rect_t opaque_rect;
+                clippers[i] = get_rect_intersection(*clipper, child->screen_location);
+                if (clippers[i].size.width == 0 || clippers[i].size.height == 0) continue;
+                if (!ei_region_is_empty(&occluders)){
+                        ei_region_set_rect(&visible, &clippers[i]);
+                        ei_region_subtract(&visible, &visible, &occluders);
+                        //l'enfant est redessiné dans le rectangle englobant de sa partie visible
+                        clippers[i] = ei_region_extents(&visible);
+                        if (clippers[i].size.width == 0 || clippers[i].size.height == 0) continue;
                 }
-                child = child->next_sibling;
-                if (child) {
-                        new_clipper = get_rect_intersection(*clipper, child->screen_location);
+                if (child->geom_params && child->geom_params->manager && ei_impl_widget_opaque_rect(child, &opaque_rect)){
+                        opaque_rect = get_rect_intersection(opaque_rect, clippers[i]);
+                        ei_region_union_rect(&occluders, &opaque_rect);
                 }
         }
+        ei_region_free(&occluders);
+        ei_region_free(&visible);
+
+        for (i = 0; i < nb_children; i++){
+                if (clippers[i].size.width != 0 && clippers[i].size.height != 0) {
+                        ei_impl_widget_draw_children(children[i], surface, pick_surface, &clippers[i]);
+                }
+        }
+        if (children != children_buffer) free(children);
+        if (clippers != clippers_buffer) free(clippers);
 }
 
 
@@ -72,7 +112,7 @@ uint32_t	ei_impl_map_rgba(ei_surface_t surface, ei_color_t color);
  * @return un espace assez grand pour stocker un widget de classe frame.
  */
 ei_widget_t ei_impl_alloc_frame(){
-        return calloc(1,sizeof(ei_impl_frame_t));
+        return ei_impl_slab_alloc(&frame_slab);
 }
 
 
@@ -85,7 +125,7 @@ void ei_impl_release_frame(ei_widget_t frame){
         if (((ei_impl_frame_t*)frame)->text) free((((ei_impl_frame_t*)frame)->text));
         if (((ei_impl_frame_t*)frame)->image) hw_surface_free((((ei_impl_frame_t*)frame)->image));
         if (((ei_impl_frame_t*)frame)->rect_image) free(((ei_impl_frame_t*)frame)->rect_image);
-        free((ei_impl_frame_t*)frame);
+        ei_impl_slab_free(&frame_slab, frame);
 }
 
 
@@ -112,20 +152,16 @@ void ei_impl_draw_frame(ei_widget_t widget,ei_surface_t surface,ei_surface_t pic
         ei_point_t rounded_frame[40];
 
         int radius;
-        if (strcmp(widget->wclass->name,"button\0")==0) radius = ((ei_impl_button_t*)widget)->rayon;
+        if (ei_impl_widget_is(widget, ei_atom_button)) radius = ((ei_impl_button_t*)widget)->rayon;
         else radius = 0;
 
-        give_rounded_frame(rounded_frame, rect, radius);
         ei_point_t upper_frame[23];
         ei_point_t lower_frame[23];
         ei_point_t smaller_frame[40];
 
+        give_rounded_frames(rounded_frame, smaller_frame, rect, radius, border);
         give_upper_frame(rounded_frame,rect,h,upper_frame);
         give_lower_frame(rounded_frame,rect,h,lower_frame);
-        give_rounded_frame(smaller_frame,
-                           (ei_rect_t){(ei_point_t){rect.top_left.x+border,rect.top_left.y+border},
-                                       (ei_size_t){rect.size.width - 2*border, rect.size.height - 2*border}},
-                                       radius-border);
 
         ei_color_t light_color  = (ei_color_t){color.red + 50 < 255 ? color.red + 50 : 255,
                                            color.green + 50 < 255 ? color.green + 50 : 255,
@@ -174,25 +210,21 @@ void ei_impl_draw_frame(ei_widget_t widget,ei_surface_t surface,ei_surface_t pic
         }
 
         //on dessine sur la pick surface aussi. pour afficher la pick surface decommenter la ligne du dessous
-        //ei_draw_polygon(surface,rounded_frame,40,*(widget->pick_color),&new_clipper);
-        ei_draw_polygon(pick_surface,rounded_frame,40,*(widget->pick_color),&new_clipper);
+        //ei_draw_polygon(surface,rounded_frame,40,widget->pick_color,&new_clipper);
+        if (pick_surface) ei_draw_polygon(pick_surface,rounded_frame,40,widget->pick_color,&new_clipper);
 
 
         if (((ei_impl_frame_t*)widget)->text) {//dessin du text
-                ei_surface_t surface_text = hw_text_create_surface(((ei_impl_frame_t *) widget)->text,
-                                                           ((ei_impl_frame_t *) widget)->text_font,
-                                                           ((ei_impl_frame_t *) widget)->text_color);
+                ei_size_t size_text = ei_impl_text_size(((ei_impl_frame_t *) widget)->text,
+                                                        ((ei_impl_frame_t *) widget)->text_font);
 
-                ei_point_t where = place_text(rect,((ei_impl_frame_t *) widget)->text_anchor,
-                                              hw_surface_get_size(surface_text));
+                ei_point_t where = place_text(rect,((ei_impl_frame_t *) widget)->text_anchor, size_text);
 
                 if (((ei_impl_frame_t*)widget)->frame_relief == ei_relief_sunken) where = (ei_point_t){where.x,where.y + 2};
 
                 ei_draw_text(surface, &where, ((ei_impl_frame_t *) widget)->text,
                      ((ei_impl_frame_t *) widget)->text_font, ((ei_impl_frame_t *) widget)->text_color,
                      &new_clipper);
-
-                hw_surface_free(surface_text);
         }
 
         hw_surface_lock(surface);
@@ -204,7 +236,7 @@ void ei_impl_draw_frame(ei_widget_t widget,ei_surface_t surface,ei_surface_t pic
 void ei_impl_setdefaults_frame(ei_widget_t widget){
         ei_impl_frame_t* frame = (ei_impl_frame_t*)widget;
         widget->destructor = NULL;
-        frame->widget.wclass = ei_widgetclass_from_name((ei_const_string_t){"frame\0"});
+        frame->widget.wclass = ei_impl_atom_class(ei_atom_frame);
         frame->widget.user_data = NULL;
         frame->widget.destructor = NULL;
 
@@ -213,6 +245,7 @@ void ei_impl_setdefaults_frame(ei_widget_t widget){
         frame->widget.children_head=NULL;	///< Pointer to the first child of this widget.	Children are chained with the "next_sibling" field.
         frame->widget.children_tail=NULL;	///< Pointer to the last child of this widget.
         frame->widget.next_sibling=NULL;	///< Pointer to the next child of this widget's parent widget.
+        frame->widget.prev_sibling=NULL;	///< Pointer to the previous child of this widget's parent widget.
 
         /* Geometry Management */
         frame->widget.geom_params = (ei_geom_param_t){NULL};	///< Pointer to the geometry management parameters for this widget. If NULL, the widget is not currently managed and thus, is not displayed on the screen.
@@ -238,6 +271,45 @@ void ei_impl_draw_button(ei_widget_t widget,ei_surface_t surface,ei_surface_t pi
         ei_impl_draw_frame(widget,surface,pick_surface,clipper);
 }
 
+/**
+ * \brief Fonction d'opacité des frames : tout le rectangle si la couleur est opaque.
+ */
+bool ei_impl_opaque_frame(ei_widget_t widget, ei_rect_t* opaque_rect){
+        //les couleurs claire et sombre du relief gardent l'alpha de la couleur du frame
+        if (((ei_impl_frame_t*)widget)->frame_color.alpha != 0xFF) return false;
+        *opaque_rect = widget->screen_location;
+        return true;
+}
+
+/**
+ * \brief Fonction d'opacité des buttons : la bande horizontale entre les coins arrondis si la couleur est opaque.
+ */
+bool ei_impl_opaque_button(ei_widget_t widget, ei_rect_t* opaque_rect){
+        ei_impl_button_t* button = (ei_impl_button_t*)widget;
+        if (!ei_impl_opaque_frame(widget, opaque_rect)) return false;
+        //sans relief le button est dessiné par ei_fill : tout le rectangle est couvert
+        if (button->frame.frame_relief == ei_relief_none || button->rayon <= 0) return true;
+        opaque_rect->top_left.y  += button->rayon;
+        opaque_rect->size.height -= 2 * button->rayon;
+        return opaque_rect->size.height > 0;
+}
+
+/**
+ * \brief Test de forme des frames : le frame est dessiné sur la pick surface sur tout son rectangle.
+ */
+bool ei_impl_hit_frame(ei_widget_t widget, ei_point_t where){
+        return true;
+}
+
+/**
+ * \brief Test de forme des buttons : le cadre aux coins arrondis dessiné sur la pick surface.
+ */
+bool ei_impl_hit_button(ei_widget_t widget, ei_point_t where){
+        ei_point_t rounded_frame[40];
+        give_rounded_frame(rounded_frame, widget->screen_location, ((ei_impl_button_t*)widget)->rayon);
+        return ei_impl_raster_polygon_contains(rounded_frame, 40, where);
+}
+
 
 /**
  *  \brief fonction pour alloué un espace pour un widget button.
@@ -245,7 +317,7 @@ void ei_impl_draw_button(ei_widget_t widget,ei_surface_t surface,ei_surface_t pi
  * @return un espace assez grand pour stocker un widget de classe button.
  */
 ei_widget_t ei_impl_alloc_button(){
-        return calloc(1,sizeof(ei_impl_button_t));
+        return ei_impl_slab_alloc(&button_slab);
 }
 
 
@@ -263,7 +335,7 @@ void ei_impl_release_button(ei_widget_t button){
         if (((ei_impl_frame_t*)button)->image) hw_surface_free((((ei_impl_frame_t*)button)->image));
         if (((ei_impl_frame_t*)button)->rect_image) free(((ei_impl_frame_t*)button)->rect_image);
 
-        free((ei_impl_button_t*)button);
+        ei_impl_slab_free(&button_slab, button);
 }
 
 
@@ -274,7 +346,7 @@ void ei_impl_release_button(ei_widget_t button){
 void ei_impl_setdefaults_button(ei_widget_t widget){
         ei_impl_button_t* button = (ei_impl_button_t*)widget;
         ei_impl_setdefaults_frame(widget);
-        widget->wclass =ei_widgetclass_from_name((ei_const_string_t){"button\0"});
+        widget->wclass =ei_impl_atom_class(ei_atom_button);
         button->rayon = k_default_button_corner_radius;
         button->user_params=NULL;
         button->callback=NULL;
@@ -297,7 +369,7 @@ bool ei_callback_clickbutton(ei_widget_t		widget, struct ei_event_t*	event, ei_u
                 return true;
         }
         if (!widget) return false;
-        if (strcmp( widget->wclass->name, (ei_widgetclass_name_t){"button\0"}) != 0 ){
+        if (!ei_impl_widget_is(widget, ei_atom_button)){
                 return false; //Si le widget n'est pas un boutton on retourne false
         }
         else{
@@ -332,7 +404,8 @@ bool ei_callback_clickbutton(ei_widget_t		widget, struct ei_event_t*	event, ei_u
 
 
 /**
- * Callback intern appele lorsque l'on clique sur un widget, cela le met en premier plan.
+ * Callback intern appele lorsque l'on clique sur un widget, cela le met en premier plan (seule la zone
+ * découverte est redessinée, voir \ref modify_hierarchy).
  * @param widget
  * @param event
  * @param user_param
@@ -340,35 +413,41 @@ bool ei_callback_clickbutton(ei_widget_t		widget, struct ei_event_t*	event, ei_u
  */
 bool ei_callback_buttondown (ei_widget_t		widget, struct ei_event_t*	event, ei_user_param_t	user_param){
         if (!widget) return false;
+        //modify_hierarchy n'invalide que la zone découverte par le passage au premier plan
         modify_hierarchy(widget,widget->parent);
-        ei_app_invalidate_rect(&ei_app_root_widget()->screen_location);
         return false;
 }
 
 
 /**
- * @brief Supprime widget_supr des enfants de widget.
+ * @brief Supprime widget_supr des enfants de widget, en temps constant (liste doublement chaînée).
+ * Sans effet si widget_supr a déjà été retiré.
  * @param widget
  * @param widget_supr
  */
 void supr_hierachy(ei_widget_t widget, ei_widget_t widget_supr){
-        if (!widget) return;
-        ei_widget_t prec= widget->children_head;
+        if (!widget || !widget_supr) return;
+        //déjà retiré (par ei_widget_destroy, avant la releasefunc de la classe)
+        if (!widget_supr->prev_sibling && widget->children_head != widget_supr) return;
+
+        if (widget_supr->prev_sibling) widget_supr->prev_sibling->next_sibling = widget_supr->next_sibling;
+        else widget->children_head = widget_supr->next_sibling;
+        if (widget_supr->next_sibling) widget_supr->next_sibling->prev_sibling = widget_supr->prev_sibling;
+        else widget->children_tail = widget_supr->prev_sibling;
+        widget_supr->prev_sibling = NULL;
+        widget_supr->next_sibling = NULL;
+}
 
-        if (prec==widget_supr){
-                widget->children_head = widget->children_head->next_sibling;
-                return;
-        }
-        else{
-                ei_widget_t current = prec->next_sibling;
-                while(current){
-                        if (current==widget_supr){
-                                prec->next_sibling = current->next_sibling;
-                                if (current == widget->children_tail) widget->children_tail = prec;
-                        return;
-                        }
-                        prec=current;
-                        current=current->next_sibling;
-                }
-        }
-}
\ No newline at end of file
+/**
+ * @brief Ajoute child à la fin des enfants de parent (il est donc dessiné au dessus), en temps constant.
+ * @param parent
+ * @param child un widget qui n'est dans aucune liste d'enfants
+ */
+void ei_impl_widget_append_child(ei_widget_t parent, ei_widget_t child){
+        child->parent = parent;
+        child->next_sibling = NULL;
+        child->prev_sibling = parent->children_tail;
+        if (parent->children_tail) parent->children_tail->next_sibling = child;
+        else parent->children_head = child;
+        parent->children_tail = child;
+}
@@ -15,6 +15,7 @@
 #include "ei_application.h"
 #include "ei_event.h"
 #include "ei_outil_geom.h"
+#include "ei_impl_text.h"
 #include "ei_implementation_toplevel.h"
 
 
@@ -25,7 +26,7 @@
 typedef struct ei_impl_widget_t {
 	ei_widgetclass_t*	wclass;		///< The class of widget of this widget. Avoids the field name "class" which is a keyword in C++.
 	uint32_t		pick_id;	///< Id of this widget in the picking offscreen.
-	ei_color_t*		pick_color;	///< pick_id encoded as a color.
+	ei_color_t		pick_color;	///< pick_id encoded as a color.
 	void*			user_data;	///< Pointer provided by the programmer for private use. May be NULL.
 	ei_widget_destructor_t	destructor;	///< Pointer to the programmer's function to call before destroying this widget. May be NULL.
 
@@ -34,12 +35,14 @@ typedef struct ei_impl_widget_t {
 	ei_widget_t		children_head;	///< Pointer to the first child of this widget.	Children are chained with the "next_sibling" field.
 	ei_widget_t		children_tail;	///< Pointer to the last child of this widget.
 	ei_widget_t		next_sibling;	///< Pointer to the next child of this widget's parent widget.
+	ei_widget_t		prev_sibling;	///< Pointer to the previous child of this widget's parent widget.
 
 	/* Geometry Management */
 	ei_geom_param_t		geom_params;	///< Pointer to the geometry management parameters for this widget. If NULL, the widget is not currently managed and thus, is not displayed on the screen.
 	ei_size_t		requested_size;	///< See \ref ei_widget_get_requested_size.
 	ei_rect_t		screen_location;///< See \ref ei_widget_get_screen_location.
 	ei_rect_t*		content_rect;	///< See ei_widget_get_content_rect. By defaults, points to the screen_location.
+	uint8_t			layout_flags;	///< Marks of the deferred geometry computation (see ei_impl_layout.h).
 } ei_impl_widget_t;
 
 /**
@@ -96,6 +99,7 @@ typedef struct {
  * - ei_size_t minimal_size : size minimale que le gestionnaire de géométrie devra prendre en compte.
  * -ei_widget_t button : bouton de fermeture du toplevel
  * -ei_widget_t frame : frame pour redimmensionner le toplevel
+ * -ei_font_t title_font : police du titre, partagée par le registre des polices (ei_impl_font.h)
  */
 typedef struct {
         ei_impl_widget_t widget;
@@ -108,6 +112,7 @@ typedef struct {
         ei_widget_t button;
         ei_widget_t frame;
         ei_widget_t contain_frame;
+        ei_font_t title_font;
 }ei_impl_toplevel_t;
 
 
@@ -145,6 +150,75 @@ void		ei_impl_widget_draw_children	(ei_widget_t		widget,
 						 ei_rect_t*		clipper);
 
 
+/**
+ * @brief	Type des fonctions par lesquelles une classe de widget déclare la partie opaque d'un widget :
+ *		un rectangle (coordonnées écran) que le dessin du widget et de ses enfants recouvre
+ *		entièrement de pixels opaques, sur la surface et sur la pick surface.
+ *
+ * @param	widget		Le widget.
+ * @param	opaque_rect	Où écrire le rectangle opaque.
+ *
+ * @return			false si le widget n'a pas de partie opaque.
+ */
+typedef bool	(*ei_impl_opaquefunc_t)		(ei_widget_t		widget,
+						 ei_rect_t*		opaque_rect);
+
+/**
+ * @brief	Déclare la fonction d'opacité d'une classe de widget. Les classes qui n'en déclarent pas
+ *		(par exemple les classes externes) ne masquent jamais leurs frères.
+ */
+void		ei_impl_widgetclass_set_opaquefunc(ei_widgetclass_t*	wclass,
+						 ei_impl_opaquefunc_t	opaquefunc);
+
+/**
+ * @brief	Partie opaque d'un widget, selon la fonction d'opacité de sa classe.
+ *
+ * @return			false si le widget n'a pas de partie opaque.
+ */
+bool		ei_impl_widget_opaque_rect	(ei_widget_t		widget,
+						 ei_rect_t*		opaque_rect);
+
+/**
+ * @brief	Donne le widget qui porte le pick id, en temps constant (index maintenu par \ref ei_widget_create
+ *		et \ref ei_widget_destroy).
+ *
+ * @return			le widget, NULL si aucun widget ne porte ce pick id.
+ */
+ei_widget_t	ei_impl_widget_from_pickid	(uint32_t		pick_id);
+
+/**
+ * @brief	Libère l'index des pick ids (appelée par \ref ei_app_free, après la destruction des widgets).
+ */
+void		ei_impl_pick_index_free		(void);
+
+/**
+ * @brief	Type des tests de forme exacts utilisés par le picking géométrique (voir ei_impl_pick.h) : le
+ *		point est déjà dans la partie visible du rectangle du widget, la fonction dit s'il est aussi
+ *		dans la forme dessinée sur la pick surface (coins arrondis par exemple).
+ *
+ * @param	widget		Le widget.
+ * @param	where		Le point, en coordonnées de la fenêtre racine.
+ */
+typedef bool	(*ei_impl_hitfunc_t)		(ei_widget_t		widget,
+						 ei_point_t		where);
+
+/**
+ * @brief	Déclare le test de forme d'une classe de widget, utilisé par le picking géométrique.
+ */
+void		ei_impl_widgetclass_set_hitfunc	(ei_widgetclass_t*	wclass,
+						 ei_impl_hitfunc_t	hitfunc);
+
+/**
+ * @brief	Renvoie le test de forme de la classe, NULL si elle n'en a pas déclaré.
+ */
+ei_impl_hitfunc_t ei_impl_widgetclass_hitfunc	(ei_widgetclass_t*	wclass);
+
+/**
+ * @brief	Libère la table des extensions des classes (appelée par \ref ei_app_free).
+ */
+void		ei_impl_widgetclass_free_ext	(void);
+
+
 /**
  * \brief	Converts the red, green, blue and alpha components of a color into a 32 bits integer
  * 		than can be written directly in the memory returned by \ref hw_surface_get_buffer.
@@ -202,6 +276,16 @@ void ei_impl_draw_frame(ei_widget_t widget,ei_surface_t surface,ei_surface_t pic
  */
 void ei_impl_setdefaults_frame(ei_widget_t);
 
+/**
+ * \brief Fonction d'opacité des frames : tout le rectangle si la couleur est opaque.
+ */
+bool ei_impl_opaque_frame(ei_widget_t widget, ei_rect_t* opaque_rect);
+
+/**
+ * \brief Test de forme des frames : le frame est dessiné sur la pick surface sur tout son rectangle.
+ */
+bool ei_impl_hit_frame(ei_widget_t widget, ei_point_t where);
+
 
 //======================================= button
 
@@ -239,6 +323,16 @@ void ei_impl_setdefaults_button(ei_widget_t widget);
 */
 void ei_impl_draw_button(ei_widget_t widget,ei_surface_t surface,ei_surface_t pick_surface,ei_rect_t* clipper);
 
+/**
+ * \brief Fonction d'opacité des buttons : la bande horizontale entre les coins arrondis si la couleur est opaque.
+ */
+bool ei_impl_opaque_button(ei_widget_t widget, ei_rect_t* opaque_rect);
+
+/**
+ * \brief Test de forme des buttons : le cadre aux coins arrondis dessiné sur la pick surface.
+ */
+bool ei_impl_hit_button(ei_widget_t widget, ei_point_t where);
+
 
 /**
  * @brief Callback interne des buttons. Utilise la variable globale "current_button_down" afin de savoir si on utilise mouse_buttonup en dehors du bouton courant
@@ -261,10 +355,24 @@ bool ei_callback_buttondown (ei_widget_t		widget, struct ei_event_t*	event, ei_u
 
 
 /**
- * @brief Supprime widget_supr des enfants de widget.
+ * @brief Supprime widget_supr des enfants de widget, en temps constant (liste doublement chaînée).
+ * Sans effet si widget_supr a déjà été retiré.
  * @param widget
  * @param widget_supr
  */
 void supr_hierachy(ei_widget_t widget, ei_widget_t widget_supr);
 
+/**
+ * @brief Ajoute child à la fin des enfants de parent (il est donc dessiné au dessus), en temps constant.
+ * @param parent
+ * @param child un widget qui n'est dans aucune liste d'enfants
+ */
+void ei_impl_widget_append_child(ei_widget_t parent, ei_widget_t child);
+
+/**
+ * @brief Passe de layout, puis dessin et affichage de la zone abîmée : une image de la boucle principale (sans
+ * les animations). Appelée par \ref ei_app_run, et par les benchmarks qui mesurent le coût d'une image.
+ */
+void ei_impl_app_render(void);
+
 #endif
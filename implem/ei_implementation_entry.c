@@ -13,6 +13,9 @@
 #include "ei_types.h"
 #include "ei_widget_configure.h"
 #include "ei_impl_placer.h"
+#include "ei_impl_raster.h"
+#include "ei_impl_atom.h"
+#include "ei_impl_slab.h"
 #include "ei_implementation_entry.h"
 #include "ei_entry.h"
 
@@ -23,8 +26,10 @@ extern ei_impl_entry_t *current_entry_focus;
  *
  * @return un espace assez grand pour stocker un widget de classe entry.
  */
+static ei_impl_slab_t entry_slab = EI_IMPL_SLAB_INIT(sizeof(ei_impl_entry_t));
+
 ei_widget_t ei_impl_alloc_entry(){
-        return calloc(1,sizeof(ei_impl_entry_t));
+        return ei_impl_slab_alloc(&entry_slab);
 }
 
 /**
@@ -33,8 +38,8 @@ ei_widget_t ei_impl_alloc_entry(){
  */
 
 void ei_impl_release_entry(ei_widget_t entry){
-        supr_hierachy(ei_app_root_widget(), entry);
-        free((ei_impl_entry_t*)entry);
+        supr_hierachy(entry->parent, entry);
+        ei_impl_slab_free(&entry_slab, entry);
 }
 
 /**
@@ -43,7 +48,7 @@ void ei_impl_release_entry(ei_widget_t entry){
 void ei_impl_setdefaults_entry(ei_widget_t widget){
         ei_impl_entry_t* entry = (ei_impl_entry_t*)widget;
         widget->destructor = NULL;
-        entry->widget.wclass = ei_widgetclass_from_name((ei_const_string_t){"entry\0"});
+        entry->widget.wclass = ei_impl_atom_class(ei_atom_entry);
         entry->widget.user_data = NULL;
         entry->widget.destructor = NULL;
 
@@ -52,6 +57,7 @@ void ei_impl_setdefaults_entry(ei_widget_t widget){
         entry->widget.children_head=NULL;	///< Pointer to the first child of this widget.	Children are chained with the "next_sibling" field.
         entry->widget.children_tail=NULL;	///< Pointer to the last child of this widget.
         entry->widget.next_sibling=NULL;	///< Pointer to the next child of this widget's parent widget.
+        entry->widget.prev_sibling=NULL;	///< Pointer to the previous child of this widget's parent widget.
 
         /* Geometry Management */
         entry->widget.geom_params = NULL;	///< Pointer to the geometry management parameters for this widget. If NULL, the widget is not currently managed and thus, is not displayed on the screen.
@@ -72,6 +78,30 @@ void ei_impl_geomnotify_entry(ei_widget_t widget){
 
 }
 
+/**
+* \brief Fonction d'opacité des entries : le fond (gris, ou noir avec le focus) est opaque.
+*/
+bool ei_impl_opaque_entry(ei_widget_t widget, ei_rect_t* opaque_rect){
+        if (ei_default_background_color.alpha != 0xFF) return false;
+        //le fond est dessiné avec la taille demandée, à partir du coin haut gauche
+        *opaque_rect = get_rect_intersection((ei_rect_t){widget->screen_location.top_left, widget->requested_size},
+                                             widget->screen_location);
+        return opaque_rect->size.width > 0 && opaque_rect->size.height > 0;
+}
+
+/**
+* \brief Test de forme des entries : le fond, de la taille demandée, dessiné sur la pick surface.
+*/
+bool ei_impl_hit_entry(ei_widget_t widget, ei_point_t where){
+        ei_point_t top_left = widget->screen_location.top_left;
+        ei_size_t size = widget->requested_size;
+        ei_point_t bigger_frame[4] = { top_left,
+                    (ei_point_t){top_left.x + size.width, top_left.y},
+                    (ei_point_t){top_left.x + size.width, top_left.y + size.height},
+                    (ei_point_t){top_left.x, top_left.y + size.height}};
+        return ei_impl_raster_polygon_contains(bigger_frame, 4, where);
+}
+
 
 /**
 * \brief Structure pour le stockage des lettres
@@ -176,12 +206,16 @@ void delete_at_cursor_position(const char* text, int position) {
 
 bool ei_callback_entry(ei_widget_t		widget, struct ei_event_t*	event, ei_user_param_t	user_param){
 
+        //le bind est appelé pour tous les widgets : seuls les clics sur une entry et les touches quand une entry
+        //a le focus la concernent
         if (event->type == ei_ev_mouse_buttondown){
+                if (!widget || !ei_impl_widget_is(widget, ei_atom_entry)) return false;
                 ei_app_invalidate_rect(&widget->screen_location);
                 ei_entry_give_focus(widget);
         }
         if (event->type == ei_ev_keydown ){
                 widget = current_entry_focus;
+                if (!widget) return false;
                 if ((event->param.key_code == SDLK_a ||
                     event->param.key_code == SDLK_b ||
                     event->param.key_code == SDLK_c ||
@@ -221,6 +255,7 @@ bool ei_callback_entry(ei_widget_t		widget, struct ei_event_t*	event, ei_user_pa
                         return true;
                 }
         }
+        return false;
 }
 
 
@@ -259,19 +294,17 @@ void ei_impl_draw_entry(ei_widget_t widget,ei_surface_t surface,ei_surface_t pic
 
         ei_draw_polygon(surface,bigger_frame,4, bg_color ,&new_clipper);
         ei_draw_polygon(surface,white_frame,4, white ,&new_clipper);
-        ei_draw_polygon(pick_surface,bigger_frame,4,*(widget->pick_color),&new_clipper);
+        if (pick_surface) ei_draw_polygon(pick_surface,bigger_frame,4,widget->pick_color,&new_clipper);
 
         if (((ei_impl_entry_t*)widget)->text) {
                 ei_impl_entry_t* cc = ((ei_impl_entry_t *) widget);
-                ei_surface_t surface_text = hw_text_create_surface(((ei_impl_entry_t *) widget)->text,
-                                                           ((ei_impl_entry_t *) widget)->text_font,
-                                                           ((ei_impl_entry_t *) widget)->text_color);
+                ei_size_t size_text = ei_impl_text_size(((ei_impl_entry_t *) widget)->text,
+                                                        ((ei_impl_entry_t *) widget)->text_font);
 
-                ei_point_t where = place_text(rect,((ei_impl_entry_t *) widget)->text_anchor, hw_surface_get_size(surface_text));
+                ei_point_t where = place_text(rect,((ei_impl_entry_t *) widget)->text_anchor, size_text);
                 ei_draw_text(surface, &where, ((ei_impl_entry_t *) widget)->text,
                      ((ei_impl_entry_t *) widget)->text_font, ((ei_impl_entry_t *) widget)->text_color,
                      &widget->screen_location);
-                hw_surface_free(surface_text);
         }
 
         hw_surface_lock(surface);
@@ -36,5 +36,15 @@ bool ei_callback_entry(ei_widget_t		widget, struct ei_event_t*	event, ei_user_pa
 
 void ei_impl_geomnotify_entry(ei_widget_t widget);
 
+/**
+* \brief Fonction d'opacité des entries : le fond (gris, ou noir avec le focus) est opaque.
+*/
+bool ei_impl_opaque_entry(ei_widget_t widget, ei_rect_t* opaque_rect);
+
+/**
+* \brief Test de forme des entries : le fond, de la taille demandée, dessiné sur la pick surface.
+*/
+bool ei_impl_hit_entry(ei_widget_t widget, ei_point_t where);
+
 #endif //PROJETC_IG_EI_IMPLEMENTATION_ENTRY_H
 
@@ -10,6 +10,13 @@
 #include "ei_types.h"
 #include "ei_widget_configure.h"
 #include "ei_impl_placer.h"
+#include "ei_impl_raster.h"
+#include "ei_impl_atom.h"
+#include "ei_impl_slab.h"
+#include "ei_impl_font.h"
+#include "ei_impl_layout.h"
+#include "ei_impl_region.h"
+#include "ei_impl_pick.h"
 
 
 
@@ -17,50 +24,39 @@
 
 /**
 * \brief Fonction pour modifier la hiérarchie des widgets pour que le widget appelé écrase les autres fils de son parent : pour cela on le met à la fin
-* de la liste des enfants.
+* de la liste des enfants. Seule la zone découverte est invalidée : la partie du widget que recouvraient les frères dessinés après lui.
 */
 
 void modify_hierarchy( ei_widget_t widget , ei_widget_t parent)
 {
         if (!parent) return;
-        ei_widget_t tmp = parent->children_head;
+        // Si le widget n'est pas déjà en dernier, on le retire et on le remet à la fin (en temps constant). Si le
+        // parent du widget est un toplevel on ne modifie pas sa hierarchie (elle sera toujours la meme)
+        if (widget->next_sibling && !ei_impl_widget_is(parent, ei_atom_toplevel)) {
+                // le widget et ses descendants sont dessinés dans son rectangle, limité par ceux de ses ancêtres
+                ei_rect_t drawn = widget->screen_location;
+                for (ei_widget_t ancestor = parent; ancestor; ancestor = ancestor->parent)
+                        drawn = get_rect_intersection(drawn, ancestor->screen_location);
+
+                // seuls les frères dessinés après lui le recouvraient : hors de ces zones, rien ne change à l'écran
+                ei_region_t exposed;
+                ei_region_init(&exposed);
+                for (ei_widget_t sibling = widget->next_sibling; sibling; sibling = sibling->next_sibling) {
+                        if (!sibling->geom_params || !sibling->geom_params->manager) continue;
+                        ei_rect_t overlap = get_rect_intersection(drawn, sibling->screen_location);
+                        ei_region_union_rect(&exposed, &overlap);
+                }
 
-        // Si le widget est déjà en dernier
-        if (!widget->next_sibling) {
-                modify_hierarchy(widget->parent, widget->parent->parent);
-                return;
-        }
-        // Si le parent du widget est un toplevel alors on ne modifie pas sa hierarchie (elle sera toujours la meme)
-        if (strcmp(parent->wclass->name,"toplevel\0") == 0){
-            modify_hierarchy(widget->parent, widget->parent->parent);
-            return;
-        }
-        // Trouver le widget dans la liste des enfants du parent
-        ei_widget_t prev = NULL;
-        ei_widget_t cur = parent->children_head;
-
-        while (cur != NULL) {
-                if (cur == widget)
-                        break;
-                prev = cur;
-                cur = cur->next_sibling;
+                supr_hierachy(parent, widget);
+                ei_impl_widget_append_child(parent, widget);
+                for (int i = 0; i < exposed.size; i++) {
+                        ei_rect_t rect = ei_region_rect(&exposed, i);
+                        ei_app_invalidate_rect(&rect);
+                }
+                ei_region_free(&exposed);
+                //l'ordre de dessin a changé : l'index du picking est à reconstruire, même sans zone découverte
+                ei_impl_pick_invalidate();
         }
-        if (!cur)
-                return;
-        if (prev)
-                prev->next_sibling = cur->next_sibling;
-        else
-                parent->children_head = cur->next_sibling;
-
-        cur->next_sibling = NULL;
-
-        // Trouver le dernier enfant et attacher le widget à sa suite
-        ei_widget_t last_child = parent->children_head;
-        while (last_child->next_sibling)
-                last_child = last_child->next_sibling;
-
-        last_child->next_sibling = cur;
-        parent->children_tail = cur;
         modify_hierarchy(widget->parent, widget->parent->parent);
 }
 
@@ -109,11 +105,8 @@ bool ei_callback_toplevel(ei_widget_t	widget, struct ei_event_t*	event, ei_user_
                 if (current_moving_toplevel->widget.screen_location.top_left.y < clip.top_left.y )
                         clip.top_left.y = current_moving_toplevel->widget.screen_location.top_left.y < 0 ? 0 : current_moving_toplevel->widget.screen_location.top_left.y ;
 
-                ei_widget_t child = current_moving_toplevel->widget.children_head;
-                while (child){
-                        if (child->geom_params)(child->geom_params->manager->runfunc)(child);
-                        child=child->next_sibling;
-                }
+                //les enfants sont replacés par la passe de layout, avant le prochain dessin
+                ei_impl_layout_mark_children(&current_moving_toplevel->widget);
                 ei_app_invalidate_rect(&clip);
                 return 1;
         }
@@ -122,7 +115,7 @@ bool ei_callback_toplevel(ei_widget_t	widget, struct ei_event_t*	event, ei_user_
         if (!widget) return false;
 
 
-        if (strcmp(widget->wclass->name, (ei_widgetclass_name_t) {"toplevel\0"}) == 0) {
+        if (ei_impl_widget_is(widget, ei_atom_toplevel)) {
 
                 ei_impl_toplevel_t *toplevel = (ei_impl_toplevel_t *) widget;
                 ei_rect_t rect = toplevel->widget.screen_location;
@@ -135,7 +128,6 @@ bool ei_callback_toplevel(ei_widget_t	widget, struct ei_event_t*	event, ei_user_
                                 current_moving_toplevel = toplevel;
                                 mouse_point = event->param.mouse.where;
                                 modify_hierarchy(widget, toplevel->widget.parent);
-                                ei_app_invalidate_rect(&ei_app_root_widget()->screen_location);
                                 return 1;
                         }
                 }
@@ -159,8 +151,8 @@ bool ei_resize_toplevel(ei_widget_t	widget, struct ei_event_t*	event, ei_user_pa
         }
         ei_point_t cur_point = event->param.mouse.where;
 
-        if (widget && resize==0 && event->type==ei_ev_mouse_buttondown && strcmp(widget->wclass->name, (ei_widgetclass_name_t) {"frame\0"})==0){
-                if      (widget->parent &&  strcmp(widget->parent->wclass->name, (ei_widgetclass_name_t) {"toplevel\0"})==0 &&
+        if (widget && resize==0 && event->type==ei_ev_mouse_buttondown && ei_impl_widget_is(widget, ei_atom_frame)){
+                if      (widget->parent &&  ei_impl_widget_is(widget->parent, ei_atom_toplevel) &&
                         ((ei_impl_toplevel_t*)widget->parent)->resizable_axis!=ei_axis_none &&
                         widget->pick_id==((ei_impl_toplevel_t*)widget->parent)->frame->pick_id){
 
@@ -205,17 +197,9 @@ bool ei_resize_toplevel(ei_widget_t	widget, struct ei_event_t*	event, ei_user_pa
 
                 mouse_point = cur_point;
 
-                ei_widget_t child = frame->widget.parent->children_head;
-                while (child){
-                        (child->geom_params->manager->runfunc)(child);
-                        child=child->next_sibling;
-                }
-
-                child = contain_frame->widget.children_head;
-                while (child){
-                        if ((child->geom_params) && (child->geom_params->manager)) (child->geom_params->manager->runfunc)(child);
-                        child=child->next_sibling;
-                }
+                //les enfants du toplevel et du contenu sont replacés par la passe de layout
+                ei_impl_layout_mark_children(frame->widget.parent);
+                ei_impl_layout_mark_children(&contain_frame->widget);
                 ei_app_invalidate_rect(&rect);
 
                 return 1;
@@ -229,8 +213,10 @@ bool ei_resize_toplevel(ei_widget_t	widget, struct ei_event_t*	event, ei_user_pa
  *
  * @return un espace assez grand pour stocker un widget de classe toplevel.
  */
+static ei_impl_slab_t toplevel_slab = EI_IMPL_SLAB_INIT(sizeof(ei_impl_toplevel_t));
+
 ei_widget_t ei_impl_alloc_toplevel(){
-        return calloc(1,sizeof(ei_impl_toplevel_t));
+        return ei_impl_slab_alloc(&toplevel_slab);
 }
 
 
@@ -249,7 +235,8 @@ void ei_impl_release_toplevel(ei_widget_t toplevel){
                 resize= false;
         }
         supr_hierachy(toplevel->parent, toplevel);
-        free((ei_impl_toplevel_t*)toplevel);
+        ei_impl_font_release(((ei_impl_toplevel_t*)toplevel)->title_font);
+        ei_impl_slab_free(&toplevel_slab, toplevel);
 }
 
 /**
@@ -274,7 +261,7 @@ bool toplevel_close(ei_widget_t	widget,
 void ei_impl_setdefaults_toplevel(ei_widget_t widget){
         ei_impl_toplevel_t* toplevel = (ei_impl_toplevel_t*)widget;
 
-        toplevel->widget.wclass =ei_widgetclass_from_name((ei_const_string_t){"toplevel\0"});
+        toplevel->widget.wclass =ei_impl_atom_class(ei_atom_toplevel);
         toplevel->widget.user_data = NULL;
         toplevel->widget.destructor = NULL;
         /* Widget Hierachy Management */
@@ -282,6 +269,7 @@ void ei_impl_setdefaults_toplevel(ei_widget_t widget){
         toplevel->widget.children_head=NULL;	///< Pointer to the first child of this widget.	Children are chained with the "next_sibling" field.
         toplevel->widget.children_tail=NULL;	///< Pointer to the last child of this widget.
         toplevel->widget.next_sibling=NULL;	///< Pointer to the next child of this widget's parent widget.
+        toplevel->widget.prev_sibling=NULL;	///< Pointer to the previous child of this widget's parent widget.
 
         /* Geometry Management */
         toplevel->widget.geom_params = (ei_geom_param_t){NULL};	///< Pointer to the geometry management parameters for this widget. If NULL, the widget is not currently managed and thus, is not displayed on the screen.
@@ -293,6 +281,9 @@ void ei_impl_setdefaults_toplevel(ei_widget_t widget){
         int border =4;
         toplevel->border_width = border;
         toplevel->title="Toplevel";
+        if (!toplevel->title_font)
+                toplevel->title_font = ei_impl_font_acquire(ei_default_font_filename, ei_style_normal,
+                                                            EI_TOPLEVEL_TITLE_FONT_SIZE);
         toplevel->can_close = true;
         toplevel->resizable_axis = ei_axis_both;
         toplevel->minimal_size = (ei_size_t){160, 120};
@@ -390,7 +381,7 @@ void ei_impl_draw_toplevel(ei_widget_t widget, ei_surface_t surface, ei_surface_
 
         ei_draw_polygon(surface,square_frame,8, dark_color, &new_clipper);
         ei_draw_polygon(surface,rounded_frame,22, dark_color, &new_clipper);
-        ei_draw_polygon(pick_surface,rounded_frame_temp,40,*(widget->pick_color),&new_clipper);
+        if (pick_surface) ei_draw_polygon(pick_surface,rounded_frame_temp,40,widget->pick_color,&new_clipper);
 
 
         ei_color_t white_color = (ei_color_t){255,255,255, 255};
@@ -399,11 +390,9 @@ void ei_impl_draw_toplevel(ei_widget_t widget, ei_surface_t surface, ei_surface_
                 uint32_t size = 10;
                 if (toplevel->button) size = toplevel->button->requested_size.width;
                 ei_point_t where = (ei_point_t){ rect.top_left.x + 2 * size, rect.top_left.y };
-                ei_font_t font = hw_text_font_create(ei_default_font_filename, ei_style_normal, 18);
                 ei_draw_text(surface, &where, toplevel->title,
-                             font, white_color,
+                             toplevel->title_font, white_color,
                              &new_clipper);
-                hw_text_font_free(font);
         }
         hw_surface_lock(surface);
 }
@@ -411,3 +400,24 @@ void ei_impl_draw_toplevel(ei_widget_t widget, ei_surface_t surface, ei_surface_
 
 void ei_impl_geomnotify_toplevel(ei_widget_t widget){
 }
+
+/**
+ * \brief Fonction d'opacité des toplevels : la zone de contenu, couverte par le frame de contenu si sa couleur
+ * est opaque (la barre de titre et la bordure sont translucides).
+ */
+bool ei_impl_opaque_toplevel(ei_widget_t widget, ei_rect_t* opaque_rect){
+        ei_widget_t contain_frame = ((ei_impl_toplevel_t*)widget)->contain_frame;
+        if (!contain_frame || !contain_frame->geom_params) return false;
+        if (!ei_impl_opaque_frame(contain_frame, opaque_rect)) return false;
+        *opaque_rect = get_rect_intersection(*opaque_rect, widget->screen_location);
+        return opaque_rect->size.width > 0 && opaque_rect->size.height > 0;
+}
+
+/**
+ * \brief Test de forme des toplevels : le cadre aux coins arrondis dessiné sur la pick surface.
+ */
+bool ei_impl_hit_toplevel(ei_widget_t widget, ei_point_t where){
+        ei_point_t rounded_frame[40];
+        give_rounded_frame(rounded_frame, widget->screen_location, k_default_button_corner_radius);
+        return ei_impl_raster_polygon_contains(rounded_frame, 40, where);
+}
@@ -65,9 +65,20 @@ bool ei_resize_toplevel(ei_widget_t	widget, struct ei_event_t*	event, ei_user_pa
 
 void ei_impl_geomnotify_toplevel(ei_widget_t widget);
 
+/**
+ * \brief Fonction d'opacité des toplevels : la zone de contenu, couverte par le frame de contenu si sa couleur
+ * est opaque (la barre de titre et la bordure sont translucides).
+ */
+bool ei_impl_opaque_toplevel(ei_widget_t widget, ei_rect_t* opaque_rect);
+
+/**
+ * \brief Test de forme des toplevels : le cadre aux coins arrondis dessiné sur la pick surface.
+ */
+bool ei_impl_hit_toplevel(ei_widget_t widget, ei_point_t where);
+
 /**
 * \brief Fonction pour modifier la hiérarchie des widgets pour que le widget appelé écrase les autres fils de son parent : pour cela on le met à la fin
-* de la liste des enfants.
+* de la liste des enfants. Seule la zone découverte est invalidée : la partie du widget que recouvraient les frères dessinés après lui.
 */
 void modify_hierarchy( ei_widget_t widget , ei_widget_t parent);
 
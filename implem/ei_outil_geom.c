@@ -68,29 +68,90 @@ ei_rect_t get_rect_intersection( ei_rect_t old_rect , ei_rect_t new_rect){
         return intersection_rect;
 }
 
-/**
- * Fonction modifiant un ensemble de points "circle" afin de créer une frame arrondie aux bords.
- * @param circle
- * @param rect
- * @param radius
+/*
+ * Cache de la géométrie des coins arrondis.
+ * - unit_cos / unit_sin : les 40 points du cercle unité (pas de pi/20), calculés une seule fois ;
+ * - corner_cache : les décalages entiers déjà calculés, un élément par couple (rayon, bordure) rencontré.
+ * Un écran de boutons identiques ne fait donc qu'une recherche par dessin (last_hit), sans trigonométrie.
  */
-void give_rounded_frame(ei_point_t* circle, ei_rect_t rect, int radius) {
+static float                    unit_cos[40];
+static float                    unit_sin[40];
+static bool                     unit_circle_ready       = false;
+
+static ei_corner_geometry_t*    corner_cache            = NULL;
+static int                      corner_cache_size       = 0;
+static int                      corner_cache_capacity   = 0;
+static int                      last_hit                = -1;
+
+static void init_unit_circle(void){
         float pi = 355./113.;
-        float xpos, ypos;
-        ei_point_t center;
         for (int i = 0; i < 40; i++){
-                xpos = cosf(((float) i / 20) * pi);
-                ypos = sinf(((float) i / 20) * pi);
-                if (0 <= i && i < 10) center = (ei_point_t) {(rect.top_left.x) + (rect.size.width) - radius,
-                    (rect.top_left.y) + radius};
-                if (10 <= i && i < 20) center = (ei_point_t) {(rect.top_left.x) + radius,
-                    (rect.top_left.y) + radius};
-                if (20 <= i && i < 30) center = (ei_point_t) {(rect.top_left.x) + radius,
-                    (rect.top_left.y) + (rect.size.height) - radius};
-                if (30 <= i)
-                    center = (ei_point_t) {(rect.top_left.x) + (rect.size.width) - radius,
-                                           (rect.top_left.y) + (rect.size.height) - radius};
-                circle[i] = (ei_point_t) {(center.x) + (xpos * radius), (center.y) - (ypos * radius)};
+                unit_cos[i] = cosf(((float) i / 20) * pi);
+                unit_sin[i] = sinf(((float) i / 20) * pi);
+        }
+        unit_circle_ready = true;
+}
+
+/*
+ * Partie entière d'un décalage. Les valeurs quasi entières (cos et sin aux multiples de pi/2, qui valent
+ * presque 0 ou presque -radius) sont arrondies, comme le faisait l'absorption par l'addition flottante
+ * au centre du coin dans l'ancien calcul.
+ */
+static int corner_offset(float v){
+        float r = roundf(v);
+        if (fabsf(v - r) < 1e-3f) return (int) r;
+        return (int) floorf(v);
+}
+
+static void compute_offsets(ei_point_t* offsets, int radius){
+        for (int i = 0; i < 40; i++){
+                offsets[i] = (ei_point_t){corner_offset(unit_cos[i] * radius), corner_offset(-unit_sin[i] * radius)};
+        }
+}
+
+/**
+ * @brief Renvoie la géométrie des coins pour (radius, border). Elle est calculée au premier appel à partir
+ * d'une table du cercle unité, puis mémorisée : les appels suivants ne font qu'une recherche.
+ *
+ * @param radius        rayon des coins du contour extérieur
+ * @param border        largeur de la bordure (0 si seul le contour extérieur est utile)
+ * @return la géométrie mémorisée, valide jusqu'à \ref free_corner_geometry_cache.
+ */
+const ei_corner_geometry_t* get_corner_geometry(int radius, int border){
+        if (last_hit >= 0 && corner_cache[last_hit].radius == radius && corner_cache[last_hit].border == border)
+                return &corner_cache[last_hit];
+        for (int i = 0; i < corner_cache_size; i++){
+                if (corner_cache[i].radius == radius && corner_cache[i].border == border){
+                        last_hit = i;
+                        return &corner_cache[i];
+                }
+        }
+
+        if (!unit_circle_ready) init_unit_circle();
+        if (corner_cache_size == corner_cache_capacity){
+                corner_cache_capacity = corner_cache_capacity ? 2 * corner_cache_capacity : 8;
+                corner_cache = realloc(corner_cache, corner_cache_capacity * sizeof(ei_corner_geometry_t));
+        }
+        ei_corner_geometry_t* geometry = &corner_cache[corner_cache_size];
+        geometry->radius = radius;
+        geometry->border = border;
+        compute_offsets(geometry->outer, radius);
+        compute_offsets(geometry->inner, radius - border);
+        last_hit = corner_cache_size++;
+        return geometry;
+}
+
+/*
+ * Place les 40 décalages autour des 4 centres de coins de rect (10 points par coin, dans le sens trigonométrique
+ * à partir du coin haut droit).
+ */
+static void place_corners(ei_point_t* circle, const ei_point_t* offsets, ei_rect_t rect, int radius){
+        ei_point_t centers[4] = {{rect.top_left.x + rect.size.width - radius, rect.top_left.y + radius},
+                                 {rect.top_left.x + radius,                   rect.top_left.y + radius},
+                                 {rect.top_left.x + radius,                   rect.top_left.y + rect.size.height - radius},
+                                 {rect.top_left.x + rect.size.width - radius, rect.top_left.y + rect.size.height - radius}};
+        for (int i = 0; i < 40; i++){
+                circle[i] = (ei_point_t){centers[i / 10].x + offsets[i].x, centers[i / 10].y + offsets[i].y};
         }
         //minimiser les erreurs d'arrondis
         circle[9].y = circle[10].y;
@@ -98,6 +159,45 @@ void give_rounded_frame(ei_point_t* circle, ei_rect_t rect, int radius) {
         circle[29].y = circle[30].y;
         circle[39].x = circle[0].x;
 }
+
+/**
+ * Fonction modifiant un ensemble de points "circle" afin de créer une frame arrondie aux bords.
+ * Les décalages des coins sont lus dans le cache de \ref get_corner_geometry : aucun calcul trigonométrique.
+ * @param circle
+ * @param rect
+ * @param radius
+ */
+void give_rounded_frame(ei_point_t* circle, ei_rect_t rect, int radius) {
+        place_corners(circle, get_corner_geometry(radius, 0)->outer, rect, radius);
+}
+
+/**
+ * @brief Ecrit dans outer le contour arrondi de rect et dans inner celui du rectangle réduit de border de chaque
+ * côté (rayon radius - border), avec une seule recherche dans le cache.
+ * @param outer         40 points, comme \ref give_rounded_frame (rect, radius)
+ * @param inner         40 points
+ * @param rect
+ * @param radius
+ * @param border
+ */
+void give_rounded_frames(ei_point_t* outer, ei_point_t* inner, ei_rect_t rect, int radius, int border){
+        const ei_corner_geometry_t* geometry = get_corner_geometry(radius, border);
+        ei_rect_t smaller = {{rect.top_left.x + border, rect.top_left.y + border},
+                             {rect.size.width - 2 * border, rect.size.height - 2 * border}};
+        place_corners(outer, geometry->outer, rect, radius);
+        place_corners(inner, geometry->inner, smaller, radius - border);
+}
+
+/**
+ * @brief Libère le cache de géométrie des coins (appelée par \ref ei_app_free).
+ */
+void free_corner_geometry_cache(void){
+        free(corner_cache);
+        corner_cache = NULL;
+        corner_cache_size = 0;
+        corner_cache_capacity = 0;
+        last_hit = -1;
+}
 /**
  *Fonction modifiant un ensemble de points "lower_frame" afin de créer une frame dont les bords de la partie basse
  *sont arrondies.
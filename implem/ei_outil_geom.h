@@ -28,6 +28,7 @@ ei_rect_t get_rect_intersection( ei_rect_t old_rect , ei_rect_t new_rect);
 
 /**
  * fonction permettant qui ecrit dans circle l'ensemble des points pour creer une frame arrondie aux bords.
+ * Les décalages des coins sont lus dans le cache de \ref get_corner_geometry : aucun calcul trigonométrique.
  * @param circle
  * @param rect
  * @param radius
@@ -35,6 +36,47 @@ ei_rect_t get_rect_intersection( ei_rect_t old_rect , ei_rect_t new_rect);
 void give_rounded_frame(ei_point_t* circle, ei_rect_t rect, int radius);
 
 
+/**
+ * @brief Géométrie des coins arrondis pour un couple (rayon, bordure) : décalages des 40 points du contour
+ * extérieur (rayon radius) et du contour intérieur (rayon radius - border) par rapport aux centres des coins.
+ */
+typedef struct ei_corner_geometry_t {
+        int             radius;
+        int             border;
+        ei_point_t      outer[40];
+        ei_point_t      inner[40];
+} ei_corner_geometry_t;
+
+
+/**
+ * @brief Renvoie la géométrie des coins pour (radius, border). Elle est calculée au premier appel à partir
+ * d'une table du cercle unité, puis mémorisée : les appels suivants ne font qu'une recherche.
+ *
+ * @param radius        rayon des coins du contour extérieur
+ * @param border        largeur de la bordure (0 si seul le contour extérieur est utile)
+ * @return la géométrie mémorisée, valide jusqu'à \ref free_corner_geometry_cache.
+ */
+const ei_corner_geometry_t* get_corner_geometry(int radius, int border);
+
+
+/**
+ * @brief Ecrit dans outer le contour arrondi de rect et dans inner celui du rectangle réduit de border de chaque
+ * côté (rayon radius - border), avec une seule recherche dans le cache.
+ * @param outer         40 points, comme \ref give_rounded_frame (rect, radius)
+ * @param inner         40 points
+ * @param rect
+ * @param radius
+ * @param border
+ */
+void give_rounded_frames(ei_point_t* outer, ei_point_t* inner, ei_rect_t rect, int radius, int border);
+
+
+/**
+ * @brief Libère le cache de géométrie des coins (appelée par \ref ei_app_free).
+ */
+void free_corner_geometry_cache(void);
+
+
 /**
  * Fonction qui ecrit dans lower_frame la partie basse du relief d'un bouton/frame
  * @param rounded_frame
@@ -17,6 +17,8 @@
 #include "ei_geometrymanager.h"
 #include "ei_widget_configure.h"
 #include "var.h"
+#include "ei_impl_placer.h"
+#include "ei_impl_layout.h"
 
 /**
  * \brief	Configures the geometry of a widget using the "placer" geometry manager.
@@ -62,7 +64,8 @@ void		ei_place	(ei_widget_t		widget,
 				 float*			rel_height){
 
         /**
-         * Ce qu'on veut de cette fonction : Qu'elle mette a jour correctement ces champs la de notre widget:
+         * Ce qu'on veut de cette fonction : Qu'elle mette a jour les paramètres du placer du widget, et
+         * qu'elle demande le calcul de ces champs la de notre widget:
          * ei_size_t		requested_size;
          * ei_rect_t		screen_location;
 	 * ei_rect_t*		content_rect;
@@ -73,86 +76,19 @@ void		ei_place	(ei_widget_t		widget,
          *
          */
         if (!widget) return;
-        if (rel_height && *rel_height!=0){
-                widget->requested_size.height = (widget->parent->requested_size.height) * (*rel_height);
-                widget->screen_location.size.height = widget->requested_size.height;
-        }
-        if (rel_width && *rel_width!=0){
-                widget->requested_size.width = (widget->parent->requested_size.width) * (*rel_width);
-                widget->screen_location.size.width = widget->requested_size.width;
-        }
-        //widget->geom_params->manager= ei_geometrymanager_from_name((char*){"placer\0"});
-        if (width && *width!=0){
-                widget->screen_location.size.width = *width;
-                widget->requested_size.width = *width;
-        }
-        if (height && *height!=0){
-                widget->requested_size.height= *height;
-                widget->screen_location.size.height = *height;
-        }
-
-        //calculer x et y en fonction de l'ancrage :
-
-        int xpos=widget->parent->screen_location.top_left.x,ypos = widget->parent->screen_location.top_left.y;
-        if (rel_x)
-                xpos = xpos + (widget->parent->requested_size.width) * (*rel_x);
-        if (rel_y)
-                ypos = ypos + (widget->parent->requested_size.height) * (*rel_y);
-        if (x) xpos = xpos + (*x);
-        if (y) ypos = ypos + (*y);
-        //printf("parent : %d %d , enfant : %d %d\n",widget->parent->screen_location.top_left.x, widget->parent->screen_location.top_left.y, xpos, ypos);
-        ei_anchor_t anc;
-        if (!anchor) anc= ei_anc_northwest;
-        else anc = *anchor;
-
-        switch (anc){
-                case ei_anc_none:
-                case ei_anc_northwest:
-                        xpos = xpos;
-                        ypos = ypos;
-                        break;
-                case ei_anc_north:
-                        xpos = xpos-(widget->requested_size.width)/2;
-                        ypos = ypos;
-                        break;
-                case ei_anc_northeast:
-                        xpos = xpos - widget->requested_size.width;
-                        ypos = ypos;
-                        break;
-                case ei_anc_west:
-                        xpos = xpos;
-                        ypos = ypos - widget->requested_size.height /2;
-                        break;
-                case ei_anc_center:
-                        xpos = xpos-(widget->requested_size.width)/2;
-                        ypos = ypos - widget->requested_size.height /2;
-                        break;
-                case ei_anc_east:
-                        xpos = xpos - widget->requested_size.width;
-                        ypos = ypos - widget->requested_size.height /2;
-                        break;
-                case ei_anc_southwest:
-                        xpos = xpos;
-                        ypos = ypos - widget->requested_size.height;
-                        break;
-                case ei_anc_south:
-                        xpos = xpos - widget->requested_size.width / 2;
-                        ypos = ypos - widget->requested_size.height;
-                        break;
-                case ei_anc_southeast:
-                        xpos = xpos - widget->requested_size.width;
-                        ypos = ypos - widget->requested_size.height;
-                        break;
-        }
-
-        if (xpos!= 0) widget->screen_location.top_left.x = xpos;
-        if (ypos!= 0) widget->screen_location.top_left.y = ypos;
-
+        //géré par un autre gestionnaire (grid) : il l'oublie d'abord
+        ei_geometrymanager_t* manager = ei_geometrymanager_from_name("placer\0");
+        if (widget->geom_params && widget->geom_params->manager != manager)
+                ei_geometrymanager_unmap(widget);
         ei_placer_t *geom_param =NULL;
-        if (widget->geom_params==NULL){
-                geom_param = calloc(1,sizeof(ei_placer_t));
+        bool new_placement = widget->geom_params==NULL;
+        if (new_placement){
+                geom_param = ei_impl_slab_alloc(&ei_impl_placer_slab);
                 ei_widget_set_geom_params(widget,(ei_geom_param_t)geom_param);
-                ei_widget_set_geom_manager(widget,ei_geometrymanager_from_name("placer\0"));
+                ei_widget_set_geom_manager(widget,manager);
+                //oublié par un autre gestionnaire (screen_location remise à 0) : on repart de la taille demandée
+                if (widget->screen_location.size.width == 0 && widget->screen_location.size.height == 0)
+                        widget->screen_location.size = widget->requested_size;
         }else
         {
                  geom_param = (ei_placer_t*)(widget->geom_params);
@@ -169,14 +105,10 @@ void		ei_place	(ei_widget_t		widget,
         if (rel_width) geom_param->rel_width   = *rel_width;
         if (anchor) geom_param->anchor      = *anchor;
 
-        ei_rect_t rect = get_rect_intersection(widget->parent->screen_location,ei_app_root_widget()->screen_location);
-
-        ei_app_invalidate_rect(&rect);
-        ei_widget_t child = widget->children_head;
-        while (child){
-                if ((child->geom_params) && (child->geom_params->manager)) (child->geom_params->manager->runfunc)(child);
-                child=child->next_sibling;
-        }
-
+        //la géométrie est calculée par la passe de layout, avant le prochain dessin (ei_impl_placer_runfunc) :
+        //placer plusieurs widgets à la suite ne recalcule chaque sous-arbre qu'une fois
+        if (new_placement) widget->layout_flags |= ei_impl_layout_new;
+        ei_impl_layout_mark(widget);
+        ei_impl_layout_mark_children(widget);
 }
 
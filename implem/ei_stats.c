@@ -0,0 +1,60 @@
+/**
+ *  @file	ei_stats.c
+ *  @brief	Built-in profiler: time spent in each phase of the main loop, and drawing counters.
+ *
+ */
+
+#include "ei_stats.h"
+#include "ei_impl_stats.h"
+
+
+/**
+ * \brief	Enables or disables the timing of the phases.
+ *
+ * @param	enabled		true to time the phases.
+ */
+void		ei_stats_enable		(bool			enabled){
+        ei_impl_stats_enabled = enabled;
+}
+
+/**
+ * \brief	Returns the timings of a phase.
+ *
+ * @param	phase		The phase.
+ * @param	summary		Where to store the timings.
+ *
+ * @return			false if the phase has no sample yet (summary is then zeroed).
+ */
+bool		ei_stats_phase		(ei_stats_phase_t	phase,
+					 ei_stats_summary_t*	summary){
+        if (!summary) return false;
+        return ei_impl_stats_summary(phase, summary);
+}
+
+/**
+ * \brief	Returns the value of a counter.
+ *
+ * @param	counter		The counter.
+ *
+ * @return			Its value.
+ */
+uint64_t	ei_stats_counter	(ei_stats_counter_t	counter){
+        if (counter < 0 || counter >= ei_stats_nb_counters) return 0;
+        return ei_impl_stats_counters[counter];
+}
+
+/**
+ * \brief	Forgets all the samples and sets all the counters to 0.
+ */
+void		ei_stats_reset		(void){
+        ei_impl_stats_reset();
+}
+
+/**
+ * \brief	Prints a report of all the phases and counters.
+ *
+ * @param	file		Where to print the report (for example stderr).
+ */
+void		ei_stats_dump		(FILE*			file){
+        if (file) ei_impl_stats_dump(file);
+}
@@ -0,0 +1,59 @@
+/**
+ *  @file	ei_timer.c
+ *  @brief	Timers: calls a function after a delay, once or periodically.
+ *
+ */
+
+#include "ei_timer.h"
+#include "ei_impl_timer.h"
+
+
+/**
+ * \brief	Starts a one-shot timer: the callback is called once, from the main loop, when the
+ *		delay has elapsed. The timer is released after the callback returns.
+ *
+ *		All the timers share a single scheduled wakeup (see \ref hw_event_schedule_app), and
+ *		are delivered directly to their callback, without going through the binds.
+ *
+ * @param	ms_delay	The delay, in milliseconds.
+ * @param	callback	The function to call.
+ * @param	user_param	A programmer supplied parameter that will be passed to the callback.
+ *
+ * @return			The timer, which may be given to \ref ei_timer_cancel until it expires.
+ */
+ei_timer_t	ei_timer_start		(int			ms_delay,
+					 ei_timer_callback_t	callback,
+					 ei_user_param_t	user_param){
+        if (!callback) return NULL;
+        return ei_impl_timer_new(ms_delay, 0, callback, user_param);
+}
+
+/**
+ * \brief	Starts a repeating timer: the callback is called every ms_period milliseconds, until
+ *		the timer is cancelled. If the main loop falls behind, missed periods are skipped
+ *		rather than delivered in a burst.
+ *
+ * @param	ms_period	The period, in milliseconds (at least 1).
+ * @param	callback	The function to call.
+ * @param	user_param	A programmer supplied parameter that will be passed to the callback.
+ *
+ * @return			The timer, to give to \ref ei_timer_cancel.
+ */
+ei_timer_t	ei_timer_repeat		(int			ms_period,
+					 ei_timer_callback_t	callback,
+					 ei_user_param_t	user_param){
+        if (!callback) return NULL;
+        if (ms_period < 1) ms_period = 1;
+        return ei_impl_timer_new(ms_period, ms_period, callback, user_param);
+}
+
+/**
+ * \brief	Cancels a timer: its callback will not be called anymore. May be called from the
+ *		callback of the timer itself. Must not be called on a one-shot timer that has already
+ *		expired.
+ *
+ * @param	timer		The timer to cancel.
+ */
+void		ei_timer_cancel		(ei_timer_t		timer){
+        ei_impl_timer_remove(timer);
+}
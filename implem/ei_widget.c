@@ -12,6 +12,10 @@
 #include "ei_implementation.h"
 #include "var.h"
 #include "ei_widgetclass.h"
+#include "ei_impl_pick.h"
+#include "ei_impl_atom.h"
+#include "ei_impl_layout.h"
+#include "ei_impl_animation.h"
 
 /**
  * @brief Definition de la variable globale permettant de donner les pick id aux widgets,
@@ -20,17 +24,95 @@
 uint32_t next_pick_id = 0x00000FFF;
 
 /**
- * @brief Donne la couleur equivalente au pick id, il faudra bien penser a free la couleur attribuée
+ * @brief Index des pick ids : pick_index[pick_id >> 8] est le widget qui porte ce pick id, NULL si l'id est libre.
+ * Les ids libérés par ei_widget_destroy sont réutilisés dans l'ordre où ils ont été libérés (file circulaire
+ * free_pick_ids) : un id n'est pas redonné juste après sa libération, quand la pick surface peut encore le contenir.
+ */
+static ei_widget_t*     pick_index              = NULL;
+static uint32_t         pick_index_size         = 0;
+static uint32_t*        free_pick_ids           = NULL;
+static uint32_t         free_pick_head          = 0;
+static uint32_t         free_pick_count         = 0;
+static uint32_t         free_pick_capacity      = 0;
+
+/**
+ * @brief Donne un pick id au widget (un id libéré s'il y en a, sinon un nouveau) et l'enregistre dans l'index.
+ */
+static uint32_t acquire_pick_id(ei_widget_t widget){
+        uint32_t pick_id;
+        if (free_pick_count > 0){
+                pick_id = free_pick_ids[free_pick_head];
+                free_pick_head = (free_pick_head + 1) % free_pick_capacity;
+                free_pick_count--;
+        } else {
+                pick_id = next_pick_id;
+                next_pick_id += 0x00000100;
+        }
+        uint32_t slot = pick_id >> 8;
+        if (slot >= pick_index_size){
+                uint32_t size = pick_index_size ? 2 * pick_index_size : 256;
+                while (size <= slot) size *= 2;
+                pick_index = realloc(pick_index, size * sizeof(ei_widget_t));
+                memset(pick_index + pick_index_size, 0, (size - pick_index_size) * sizeof(ei_widget_t));
+                pick_index_size = size;
+        }
+        pick_index[slot] = widget;
+        return pick_id;
+}
+
+/**
+ * @brief Retire le pick id de l'index et le met en file pour être réutilisé.
+ */
+static void release_pick_id(uint32_t pick_id){
+        uint32_t slot = pick_id >> 8;
+        if (slot >= pick_index_size || !pick_index[slot]) return;
+        pick_index[slot] = NULL;
+        if (free_pick_count == free_pick_capacity){
+                uint32_t capacity = free_pick_capacity ? 2 * free_pick_capacity : 64;
+                uint32_t* ids = malloc(capacity * sizeof(uint32_t));
+                for (uint32_t i = 0; i < free_pick_count; i++)
+                        ids[i] = free_pick_ids[(free_pick_head + i) % free_pick_capacity];
+                free(free_pick_ids);
+                free_pick_ids = ids;
+                free_pick_head = 0;
+                free_pick_capacity = capacity;
+        }
+        free_pick_ids[(free_pick_head + free_pick_count) % free_pick_capacity] = pick_id;
+        free_pick_count++;
+}
+
+/**
+ * @brief Donne le widget qui porte le pick id, en temps constant.
+ *
+ * @param pick_id pick id que l'on recherche
+ * @return le widget qui correspond a la pick id ou NULL.
+ */
+ei_widget_t ei_impl_widget_from_pickid(uint32_t pick_id){
+        if (pick_id == ei_app_root_widget()->pick_id) return ei_app_root_widget();
+        uint32_t slot = pick_id >> 8;
+        if (slot >= pick_index_size) return NULL;
+        return pick_index[slot];
+}
+
+/**
+ * @brief Libère l'index des pick ids (appelée par \ref ei_app_free, après la destruction des widgets).
+ */
+void ei_impl_pick_index_free(void){
+        free(pick_index);
+        free(free_pick_ids);
+        pick_index = NULL;
+        free_pick_ids = NULL;
+        pick_index_size = 0;
+        free_pick_head = free_pick_count = free_pick_capacity = 0;
+}
+
+/**
+ * @brief Donne la couleur equivalente au pick id
  * @param pickid le pick id du widget dont on souhaite la couleur
  * @return la couleur correspondant au pick id.
  */
-ei_color_t* give_color_pickid(uint32_t pickid){
-        ei_color_t* pickcolor = calloc(1,sizeof(ei_color_t));
-        pickcolor->alpha = pickid & 0xFF;
-        pickcolor->red = (pickid >> 24) & 0xFF;
-        pickcolor->green = (pickid >> 16) & 0xFF;
-        pickcolor->blue = (pickid >> 8) & 0xFF;
-        return pickcolor;
+ei_color_t give_color_pickid(uint32_t pickid){
+        return (ei_color_t){(pickid >> 24) & 0xFF, (pickid >> 16) & 0xFF, (pickid >> 8) & 0xFF, pickid & 0xFF};
 }
 
 /**
@@ -51,34 +133,27 @@ ei_widget_t		ei_widget_create		(ei_const_string_t	class_name,
 							 ei_widget_t		parent,
 							 ei_user_param_t	user_data,
 							 ei_widget_destructor_t destructor){
-        ei_widget_t new_widget = ei_widgetclass_from_name(class_name)->allocfunc();
-        new_widget->wclass = ei_widgetclass_from_name(class_name);
+        ei_widgetclass_t* wclass = ei_widgetclass_from_name(class_name);
+        if (!wclass) return NULL;
+        ei_widget_t new_widget = wclass->allocfunc();
+        new_widget->wclass = wclass;
+        new_widget->layout_flags = 0; //les classes externes ne connaissent pas ce champ
         new_widget->wclass->setdefaultsfunc(new_widget);
 
-        if (strcmp(parent->wclass->name, (ei_widgetclass_name_t){"toplevel\0"})==0) {
+        if (ei_impl_widget_is(parent, ei_atom_toplevel)) {
 
                 if (((ei_impl_toplevel_t*)parent)->contain_frame) {
 
                         parent=((ei_impl_toplevel_t*)parent)->contain_frame;
                 }
         }
-        new_widget->parent=parent;
-        parent->children_tail = new_widget;
-        ei_widget_t prec = parent->children_head;
-        if (prec==NULL) {
-                parent->children_head=new_widget;
-        }else
-        {
-                while (prec->next_sibling != NULL){
-                    prec = prec -> next_sibling;}
-                prec->next_sibling = new_widget;
-        }
-        new_widget->next_sibling = NULL;
+        //ajout en fin de liste en temps constant (children_tail)
+        ei_impl_widget_append_child(parent, new_widget);
         new_widget->user_data=user_data;
         new_widget->destructor=destructor;
-        new_widget->pick_id = next_pick_id;
-        next_pick_id += 0x00000100;
+        new_widget->pick_id = acquire_pick_id(new_widget);
         new_widget->pick_color = give_color_pickid(new_widget->pick_id);
+        ei_impl_pick_widget_created(new_widget);
         return new_widget;
 }
 
@@ -100,7 +175,11 @@ void			ei_widget_destroy		(ei_widget_t		widget){
                 child = next_child;
 
         }
-        free(widget->pick_color);
+        //le widget est retiré de la liste de son parent ici (en temps constant), pour toutes les classes
+        supr_hierachy(widget->parent, widget);
+        release_pick_id(widget->pick_id);
+        ei_impl_pick_invalidate();
+        ei_impl_animation_forget(widget);
         if (widget->destructor) (widget->destructor)(widget);
         if (widget->geom_params && widget->geom_params->manager) (widget->geom_params->manager->releasefunc)(widget);
         if (widget->wclass->releasefunc) (widget->wclass->releasefunc)(widget);
@@ -138,24 +217,6 @@ uint32_t* get_pixel_point( ei_point_t point){
         return pixel_ptr_n;
 }
 
-/**
- * @brief Donne le widget correspondant a la pickid dans les descendant de widget (fonction recursive)
- *
- * @param current widget racine
- * @param pick_id pick id que l'on recherche
- * @return le widget qui correspond a la pick id ou NULL.
- */
-ei_widget_t widget_from_pickid(ei_widget_t current, uint32_t pick_id){
-        if (!current) return NULL;
-        if (current->pick_id == pick_id) return current;
-        ei_widget_t child = current->children_head;
-        ei_widget_t result = widget_from_pickid(child,pick_id);
-        while (child && !result){
-            child=child->next_sibling;
-            result = widget_from_pickid(child,pick_id);
-        }
-        return result;
-}
 /**
  * @brief	Returns the widget that is at a given location on screen.
  *
@@ -165,11 +226,21 @@ ei_widget_t widget_from_pickid(ei_widget_t current, uint32_t pick_id){
  *				at this location (except for the root widget).
  */
 ei_widget_t		ei_widget_pick			(ei_point_t*		where){
-        //on recupere le pick_id du widget du pixel sur lequel on se trouve
-        uint32_t pick_id= (*get_pixel_point(*where)) << 8 | 0xFF; // pourquoi ? idk
-        //on trouve a quel widget il appartient et on renvoit ce widget, si c'est la racine on renvoie NULL
-        ei_widget_t current = ei_app_root_widget();
-        current = widget_from_pickid(current,pick_id);
+        ei_size_t size = ei_app_root_widget()->screen_location.size;
+        if (where->x < 0 || where->y < 0 || where->x >= size.width || where->y >= size.height) return NULL;
+        ei_widget_t current;
+        if (ei_impl_pick_mode() == ei_impl_pick_geometric) {
+                //grille sur les rectangles visibles + test de forme de la classe, sans lire de surface
+                //(la géométrie en attente est calculée d'abord : un callback a pu déplacer des widgets)
+                ei_impl_layout_run();
+                current = ei_impl_pick_geometric_widget(*where);
+        } else {
+                //on recupere le pick_id du widget du pixel sur lequel on se trouve
+                uint32_t pick_id= (*get_pixel_point(*where)) << 8 | 0xFF; // pourquoi ? idk
+                //on trouve a quel widget il appartient (index des pick ids) et on renvoit ce widget
+                current = ei_impl_widget_from_pickid(pick_id);
+        }
+        //si c'est la racine on renvoie NULL
         //printf("Je suis sur le widget %s %08x\n", current->wclass->name, current->pick_id);
         if (current == ei_app_root_widget()) return NULL;
         return current;
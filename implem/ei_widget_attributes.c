@@ -34,7 +34,7 @@ ei_widgetclass_t*	ei_widget_get_class		(ei_widget_t		widget){
  * 				in the picking offscreen.
  */
 const ei_color_t*	ei_widget_get_pick_color	(ei_widget_t		widget){
-        return widget->pick_color;
+        return &widget->pick_color;
 }
 
 /**
@@ -10,6 +10,7 @@
 
 #include "ei_widgetclass.h"
 #include "ei_implementation.h"
+#include "ei_impl_atom.h"
 
 /**
  * On implémente une liste de toutes les widgetclass.
@@ -36,6 +37,8 @@ void			ei_widgetclass_register		(ei_widgetclass_t* widgetclass){
         ei_widgetclass_t * tmp = tete;
         tete=widgetclass;
         widgetclass->next=tmp;
+        //le nom est interné : ei_widgetclass_from_name est une recherche dans la table des atomes
+        ei_impl_atom_set_class(ei_impl_atom_intern(widgetclass->name), widgetclass);
 }
 
 
@@ -48,10 +51,82 @@ void			ei_widgetclass_register		(ei_widgetclass_t* widgetclass){
  */
 
 ei_widgetclass_t*	ei_widgetclass_from_name	(ei_const_string_t name){
-        ei_widgetclass_t* current = tete;
-        while (current){
-                if (strcmp(current->name,name)==0) return current;
-                current=current->next;
+        return ei_impl_atom_class(ei_impl_atom_find(name));
+}
+
+
+/**
+ * Table des extensions des classes (fonctions d'opacité et de test de forme), à côté de la liste des classes :
+ * la structure ei_widgetclass_t est publique et les classes externes (déjà compilées) ne connaissent pas de
+ * champ supplémentaire.
+ */
+typedef struct ei_impl_class_ext_t {
+        ei_widgetclass_t*               wclass;
+        ei_impl_opaquefunc_t            opaquefunc;
+        ei_impl_hitfunc_t               hitfunc;
+        struct ei_impl_class_ext_t*     next;
+} ei_impl_class_ext_t;
+
+static ei_impl_class_ext_t* ext_head = NULL;
+
+/**
+ * @brief Renvoie l'extension de la classe, créée si create est vrai (NULL sinon).
+ */
+static ei_impl_class_ext_t* class_ext(ei_widgetclass_t* wclass, bool create){
+        for (ei_impl_class_ext_t* current = ext_head; current; current = current->next){
+                if (current->wclass == wclass) return current;
+        }
+        if (!create) return NULL;
+        ei_impl_class_ext_t* ext = calloc(1, sizeof(ei_impl_class_ext_t));
+        ext->wclass = wclass;
+        ext->next = ext_head;
+        ext_head = ext;
+        return ext;
+}
+
+/**
+ * @brief	Déclare la fonction d'opacité d'une classe de widget. Les classes qui n'en déclarent pas
+ *		(par exemple les classes externes) ne masquent jamais leurs frères.
+ */
+void		ei_impl_widgetclass_set_opaquefunc(ei_widgetclass_t*	wclass,
+						 ei_impl_opaquefunc_t	opaquefunc){
+        class_ext(wclass, true)->opaquefunc = opaquefunc;
+}
+
+/**
+ * @brief	Partie opaque d'un widget, selon la fonction d'opacité de sa classe.
+ *
+ * @return			false si le widget n'a pas de partie opaque.
+ */
+bool		ei_impl_widget_opaque_rect	(ei_widget_t		widget,
+						 ei_rect_t*		opaque_rect){
+        ei_impl_class_ext_t* ext = class_ext(widget->wclass, false);
+        return ext && ext->opaquefunc && ext->opaquefunc(widget, opaque_rect);
+}
+
+/**
+ * @brief	Déclare le test de forme d'une classe de widget, utilisé par le picking géométrique.
+ */
+void		ei_impl_widgetclass_set_hitfunc	(ei_widgetclass_t*	wclass,
+						 ei_impl_hitfunc_t	hitfunc){
+        class_ext(wclass, true)->hitfunc = hitfunc;
+}
+
+/**
+ * @brief	Renvoie le test de forme de la classe, NULL si elle n'en a pas déclaré.
+ */
+ei_impl_hitfunc_t ei_impl_widgetclass_hitfunc	(ei_widgetclass_t*	wclass){
+        ei_impl_class_ext_t* ext = class_ext(wclass, false);
+        return ext ? ext->hitfunc : NULL;
+}
+
+/**
+ * @brief	Libère la table des extensions des classes (appelée par \ref ei_app_free).
+ */
+void		ei_impl_widgetclass_free_ext	(void){
+        while (ext_head){
+                ei_impl_class_ext_t* next = ext_head->next;
+                free(ext_head);
+                ext_head = next;
         }
-        return NULL;
 }
@@ -0,0 +1,311 @@
+/**
+ * @file	hw_headless.c
+ *
+ * @brief 	Implémentation en mémoire de hw_interface.h, sans SDL ni serveur d'affichage (option CMake
+ *		IG_HEADLESS) : surfaces allouées par malloc, évènements scriptés, horloge virtuelle.
+ *		Voir hw_headless.h.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "hw_interface.h"
+#include "hw_headless.h"
+#include "ei_event.h"
+
+/**
+ * @brief Une surface : des pixels de 32 bits, ligne par ligne.
+ */
+typedef struct {
+        ei_size_t       size;
+        uint32_t*       pixels;
+        ei_point_t      origin;         ///< coordonnées du premier pixel (hw_surface_set_origin)
+        bool            alpha;
+} hw_headless_surface_t;
+
+/**
+ * @brief Une police : seule sa taille compte pour le rendu en boîtes.
+ */
+typedef struct {
+        int             size;
+        ei_fontstyle_t  style;
+} hw_headless_font_t;
+
+/**
+ * @brief Un évènement en attente (scripté ou de l'application), daté sur l'horloge virtuelle.
+ */
+typedef struct hw_headless_pending_t {
+        double                          at;
+        uint64_t                        seq;    ///< ordre d'arrivée, pour départager les évènements simultanés
+        ei_event_t                      event;
+        bool                            app;    ///< posté par hw_event_post_app ou hw_event_schedule_app
+        struct hw_headless_pending_t*   next;
+} hw_headless_pending_t;
+
+ei_font_t                       ei_default_font = NULL;
+
+static hw_headless_surface_t*   root            = NULL;
+static double                   now             = 0;
+static double                   script_time     = 0;    ///< date du dernier évènement scripté
+static uint64_t                 seq             = 0;
+static hw_headless_pending_t*   pending         = NULL; ///< triés par date puis par ordre d'arrivée
+static void                     (*idle)(void)   = NULL;
+static hw_headless_damage_t     damage;
+
+
+static hw_headless_surface_t* surface_new(ei_size_t size, bool alpha){
+        hw_headless_surface_t* surface = calloc(1, sizeof(hw_headless_surface_t));
+        surface->size = size;
+        surface->alpha = alpha;
+        surface->pixels = calloc((size_t)(size.width > 0 ? size.width : 1) * (size.height > 0 ? size.height : 1),
+                                 sizeof(uint32_t));
+        return surface;
+}
+
+/*
+ * Pixel de composantes r, g, b, a dans l'ordre des canaux des surfaces (bleu, vert, rouge, alpha en mémoire).
+ */
+static inline uint32_t pixel_of(uint8_t r, uint8_t g, uint8_t b, uint8_t a){
+        return (uint32_t)b | (uint32_t)g << 8 | (uint32_t)r << 16 | (uint32_t)a << 24;
+}
+
+/*
+ * Insère un évènement à sa date, après ceux de la même date.
+ */
+static void pending_insert(hw_headless_pending_t* item){
+        item->seq = seq++;
+        hw_headless_pending_t** link = &pending;
+        while (*link && (*link)->at <= item->at) link = &(*link)->next;
+        item->next = *link;
+        *link = item;
+}
+
+static void pending_clear(void){
+        while (pending){
+                hw_headless_pending_t* next = pending->next;
+                free(pending);
+                pending = next;
+        }
+}
+
+
+void hw_init(void){
+        now = script_time = 0;
+        seq = 0;
+        memset(&damage, 0, sizeof(damage));
+        ei_default_font = hw_text_font_create(ei_default_font_filename, ei_style_normal, ei_font_default_size);
+}
+
+void hw_quit(void){
+        pending_clear();
+        hw_text_font_free(ei_default_font);
+        ei_default_font = NULL;
+        if (root) free(root->pixels);
+        free(root);
+        root = NULL;
+}
+
+ei_surface_t hw_create_window(ei_size_t size, bool fullScreen){
+        //pas d'écran : la taille demandée est aussi celle du plein écran
+        if (!root) root = surface_new(size, false);
+        return root;
+}
+
+ei_surface_t hw_surface_create(const ei_surface_t root_surface, ei_size_t size, bool force_alpha){
+        return surface_new(size, force_alpha || (root_surface && ((hw_headless_surface_t*)root_surface)->alpha));
+}
+
+void hw_surface_free(ei_surface_t surface){
+        //la surface de la fenêtre n'est libérée que par hw_quit
+        if (!surface || surface == root) return;
+        free(((hw_headless_surface_t*)surface)->pixels);
+        free(surface);
+}
+
+void hw_surface_lock(ei_surface_t surface){
+}
+
+void hw_surface_unlock(ei_surface_t surface){
+}
+
+void hw_surface_update_rects(ei_surface_t surface, const ei_linked_rect_t* rects){
+        ei_rect_t whole = {{0, 0}, ((hw_headless_surface_t*)surface)->size};
+        ei_linked_rect_t all = {whole, NULL};
+        damage.updates++;
+        for (const ei_linked_rect_t* r = rects ? rects : &all; r; r = r->next){
+                ei_rect_t rect = r->rect;
+                damage.rects++;
+                damage.area += (int64_t)rect.size.width * rect.size.height;
+                if (damage.bounds.size.width == 0 || damage.bounds.size.height == 0){
+                        damage.bounds = rect;
+                        continue;
+                }
+                int x0 = damage.bounds.top_left.x < rect.top_left.x ? damage.bounds.top_left.x : rect.top_left.x;
+                int y0 = damage.bounds.top_left.y < rect.top_left.y ? damage.bounds.top_left.y : rect.top_left.y;
+                int x1 = damage.bounds.top_left.x + damage.bounds.size.width;
+                int y1 = damage.bounds.top_left.y + damage.bounds.size.height;
+                if (rect.top_left.x + rect.size.width > x1) x1 = rect.top_left.x + rect.size.width;
+                if (rect.top_left.y + rect.size.height > y1) y1 = rect.top_left.y + rect.size.height;
+                damage.bounds = (ei_rect_t){{x0, y0}, {x1 - x0, y1 - y0}};
+        }
+}
+
+void hw_surface_get_channel_indices(ei_surface_t surface, int* ir, int* ig, int* ib, int* ia){
+        *ir = 2;
+        *ig = 1;
+        *ib = 0;
+        *ia = ((hw_headless_surface_t*)surface)->alpha ? 3 : -1;
+}
+
+void hw_surface_set_origin(ei_surface_t surface, const ei_point_t origin){
+        ((hw_headless_surface_t*)surface)->origin = origin;
+}
+
+uint8_t* hw_surface_get_buffer(const ei_surface_t surface){
+        hw_headless_surface_t* s = surface;
+        return (uint8_t*)(s->pixels - s->origin.x - (ptrdiff_t)s->origin.y * s->size.width);
+}
+
+ei_size_t hw_surface_get_size(const ei_surface_t surface){
+        return ((hw_headless_surface_t*)surface)->size;
+}
+
+ei_rect_t hw_surface_get_rect(const ei_surface_t surface){
+        hw_headless_surface_t* s = surface;
+        return (ei_rect_t){s->origin, s->size};
+}
+
+bool hw_surface_has_alpha(ei_surface_t surface){
+        return ((hw_headless_surface_t*)surface)->alpha;
+}
+
+ei_font_t hw_text_font_create(ei_const_string_t filename, ei_fontstyle_t style, int size){
+        hw_headless_font_t* font = malloc(sizeof(hw_headless_font_t));
+        font->size = size > 1 ? size : 2;
+        font->style = style;
+        return font;
+}
+
+void hw_text_font_free(ei_font_t font){
+        free(font);
+}
+
+void hw_text_compute_size(ei_const_string_t text, const ei_font_t font, int* width, int* height){
+        int size = font ? ((hw_headless_font_t*)font)->size : ei_font_default_size;
+        *width = (int)strlen(text) * (size / 2);
+        *height = size;
+}
+
+ei_surface_t hw_text_create_surface(ei_const_string_t text, const ei_font_t font, ei_color_t color){
+        int width, height;
+        hw_text_compute_size(text, font, &width, &height);
+        hw_headless_surface_t* surface = surface_new((ei_size_t){width > 0 ? width : 1, height}, true);
+        //une boîte par caractère (sauf les espaces), bord semi-transparent comme un glyphe lissé
+        int cell = height / 2, inset = height / 8;
+        uint32_t opaque = pixel_of(color.red, color.green, color.blue, 0xFF);
+        uint32_t edge = pixel_of(color.red, color.green, color.blue, 0x80);
+        for (int c = 0; text[c]; c++){
+                if (text[c] == ' ') continue;
+                for (int y = inset; y < height - inset; y++){
+                        uint32_t* row = surface->pixels + (size_t)y * surface->size.width + c * cell;
+                        for (int x = inset / 2; x < cell - inset / 2; x++){
+                                bool border = y == inset || y == height - inset - 1 || x == inset / 2 ||
+                                              x == cell - inset / 2 - 1;
+                                row[x] = border ? edge : opaque;
+                        }
+                }
+        }
+        return surface;
+}
+
+ei_surface_t hw_image_load(ei_const_string_t filename, ei_surface_t channels){
+        //pas de décodeur d'images : un dégradé reconnaissable, de taille fixe
+        hw_headless_surface_t* surface = surface_new((ei_size_t){256, 256}, true);
+        for (int y = 0; y < 256; y++)
+                for (int x = 0; x < 256; x++)
+                        surface->pixels[y * 256 + x] = pixel_of(x, y, (x ^ y) & 0xFF, 0xFF);
+        return surface;
+}
+
+void hw_event_wait_next(struct ei_event_t* event){
+        if (!pending && idle) idle();
+        if (!pending){
+                memset(event, 0, sizeof(ei_event_t));
+                event->type = ei_ev_close;
+                return;
+        }
+        hw_headless_pending_t* first = pending;
+        pending = first->next;
+        if (first->at > now) now = first->at;
+        *event = first->event;
+        free(first);
+}
+
+int hw_event_post_app(ei_user_param_t user_param){
+        hw_event_schedule_app(0, user_param);
+        return 0;
+}
+
+void* hw_event_schedule_app(int ms_delay, ei_user_param_t user_param){
+        hw_headless_pending_t* item = calloc(1, sizeof(hw_headless_pending_t));
+        item->at = now + (ms_delay > 0 ? ms_delay : 0) / 1000.0;
+        item->app = true;
+        item->event.type = ei_ev_app;
+        item->event.param.application.user_param = user_param;
+        pending_insert(item);
+        return item;
+}
+
+bool hw_event_cancel_app(void* id){
+        for (hw_headless_pending_t** link = &pending; *link; link = &(*link)->next){
+                if (*link == id && (*link)->app){
+                        hw_headless_pending_t* item = *link;
+                        *link = item->next;
+                        free(item);
+                        return true;
+                }
+        }
+        return false;
+}
+
+double hw_now(void){
+        return now;
+}
+
+
+void hw_headless_push_event(const struct ei_event_t* event, int ms_delay){
+        if (script_time < now) script_time = now;
+        script_time += (ms_delay > 0 ? ms_delay : 0) / 1000.0;
+        hw_headless_pending_t* item = calloc(1, sizeof(hw_headless_pending_t));
+        item->at = script_time;
+        item->event = *event;
+        pending_insert(item);
+}
+
+void hw_headless_set_idle(void (*idle_function)(void)){
+        idle = idle_function;
+}
+
+void hw_headless_advance(double seconds){
+        if (seconds > 0) now += seconds;
+}
+
+void hw_headless_get_damage(hw_headless_damage_t* result){
+        *result = damage;
+}
+
+void hw_headless_reset_damage(void){
+        memset(&damage, 0, sizeof(damage));
+}
+
+uint32_t hw_headless_checksum(ei_surface_t surface){
+        hw_headless_surface_t* s = surface;
+        const uint8_t* bytes = (const uint8_t*)s->pixels;
+        size_t n = (size_t)s->size.width * s->size.height * sizeof(uint32_t);
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < n; i++){
+                //sans alpha, le 4e octet n'est pas significatif
+                if (!s->alpha && i % 4 == 3) continue;
+                hash = (hash ^ bytes[i]) * 16777619u;
+        }
+        return hash;
+}
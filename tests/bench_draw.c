@@ -0,0 +1,240 @@
+//
+//  bench_draw.c
+//
+//  Measures the primitives of ei_draw.h on offscreen surfaces from 64x64 to 3840x2160:
+//  ei_fill, ei_copy_surface (with and without alpha, aligned, shifted by one pixel, clipped),
+//  ei_draw_polygon on the shapes that libei draws (4-point rectangles, 23-point relief halves,
+//  40-point rounded frames), ei_draw_polyline and ei_draw_text.
+//
+//  One CSV line per measurement on the standard output:
+//	primitive,variant,width,height,calls,ns_per_call,mpix_per_s
+//  "calls" is the number of primitive calls that were timed, "mpix_per_s" counts the pixels that
+//  one run actually writes (measured once on a cleared surface).
+//
+//  Usage: bench_draw [seconds per measurement]	(defaults to 0.1)
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hw_interface.h"
+#include "ei_application.h"
+#include "ei_draw.h"
+#include "ei_outil_geom.h"
+#include "ei_impl_stats.h"
+
+
+static const ei_size_t		g_sizes[]	= { {64, 64}, {256, 256}, {1024, 1024}, {1920, 1080}, {3840, 2160} };
+static double			g_min_time	= 0.1;
+
+static const ei_color_t		g_opaque	= {0x88, 0x99, 0xaa, 0xff};
+static const ei_color_t		g_translucent	= {0x88, 0x99, 0xaa, 0x80};
+
+
+/*
+ * The surfaces and shapes of one size. A bench function does one run and returns the number of
+ * primitive calls it made.
+ */
+typedef struct {
+	ei_size_t	size;
+	ei_surface_t	dst;
+	ei_surface_t	src;		// same size, opaque pixels
+	ei_surface_t	src_alpha;	// same size, half-transparent pixels
+	ei_point_t	rect[4];
+	ei_point_t	relief[23];
+	ei_point_t	frame[41];	// 40 points, and the first one again to close the polyline
+	char		line[512];
+	int		line_height;
+} bench_t;
+
+typedef int (*bench_func_t)(bench_t* b);
+
+
+static ei_rect_t whole(bench_t* b)
+{
+	return (ei_rect_t){{0, 0}, b->size};
+}
+
+static ei_rect_t clipper(bench_t* b)
+{
+	// the central half of the surface, starting on an odd column
+	return (ei_rect_t){{b->size.width / 4 + 1, b->size.height / 4}, {b->size.width / 2, b->size.height / 2}};
+}
+
+static int fill_opaque(bench_t* b)		{ ei_fill(b->dst, &g_opaque, NULL); return 1; }
+static int fill_alpha(bench_t* b)		{ ei_fill(b->dst, &g_translucent, NULL); return 1; }
+static int fill_clipped(bench_t* b)		{ ei_rect_t c = clipper(b); ei_fill(b->dst, &g_opaque, &c); return 1; }
+
+static int copy_aligned(bench_t* b)		{ ei_copy_surface(b->dst, NULL, b->src, NULL, false); return 1; }
+static int copy_alpha_aligned(bench_t* b)	{ ei_copy_surface(b->dst, NULL, b->src_alpha, NULL, true); return 1; }
+
+/*
+ * Shifted by one pixel: the rows of the destination no longer start where those of the source do.
+ */
+static int copy_shifted(bench_t* b, ei_surface_t src, bool alpha)
+{
+	ei_size_t	size	= {b->size.width - 1, b->size.height};
+	ei_rect_t	dst	= {{1, 0}, size};
+	ei_rect_t	from	= {{0, 0}, size};
+
+	ei_copy_surface(b->dst, &dst, src, &from, alpha);
+	return 1;
+}
+
+static int copy_unaligned(bench_t* b)		{ return copy_shifted(b, b->src, false); }
+static int copy_alpha_unaligned(bench_t* b)	{ return copy_shifted(b, b->src_alpha, true); }
+
+/*
+ * Clipped by the destination: only its bottom-right quarter is written.
+ */
+static int copy_clipped(bench_t* b)
+{
+	ei_rect_t	dst	= {{b->size.width / 2, b->size.height / 2}, b->size};
+
+	ei_copy_surface(b->dst, &dst, b->src_alpha, NULL, true);
+	return 1;
+}
+
+static int polygon_rect(bench_t* b)		{ ei_draw_polygon(b->dst, b->rect, 4, g_opaque, NULL); return 1; }
+static int polygon_relief(bench_t* b)		{ ei_draw_polygon(b->dst, b->relief, 23, g_opaque, NULL); return 1; }
+static int polygon_frame(bench_t* b)		{ ei_draw_polygon(b->dst, b->frame, 40, g_opaque, NULL); return 1; }
+static int polygon_frame_alpha(bench_t* b)	{ ei_draw_polygon(b->dst, b->frame, 40, g_translucent, NULL); return 1; }
+static int polygon_frame_clipped(bench_t* b)	{ ei_rect_t c = clipper(b); ei_draw_polygon(b->dst, b->frame, 40, g_opaque, &c); return 1; }
+
+static int polyline_frame(bench_t* b)		{ ei_draw_polyline(b->dst, b->frame, 41, g_opaque, NULL); return 1; }
+
+/*
+ * Fills the surface with lines of text, one ei_draw_text per line.
+ */
+static int text_lines(bench_t* b)
+{
+	ei_rect_t	clip	= whole(b);
+	int		calls	= 0;
+
+	for (int y = 0; y + b->line_height <= b->size.height; y += b->line_height, calls++)
+		ei_draw_text(b->dst, &(ei_point_t){0, y}, b->line, NULL, g_opaque, &clip);
+	return calls;
+}
+
+
+/*
+ * Number of pixels that one run writes: the run is done once on a cleared destination.
+ */
+static uint64_t written_pixels(bench_t* b, bench_func_t run)
+{
+	uint32_t*	pixels	= (uint32_t*)hw_surface_get_buffer(b->dst);
+	size_t		n	= (size_t)b->size.width * b->size.height;
+	uint64_t	count	= 0;
+
+	memset(pixels, 0, n * sizeof(uint32_t));
+	run(b);
+	for (size_t i = 0; i < n; i++)
+		if (pixels[i] != 0)
+			count++;
+	return count;
+}
+
+static void measure(bench_t* b, const char* primitive, const char* variant, bench_func_t run)
+{
+	uint64_t	pixels	= written_pixels(b, run);
+	uint64_t	calls	= 0;
+	int		runs	= 0;
+	double		start	= ei_impl_stats_now();
+	double		elapsed;
+
+	do {
+		calls	+= run(b);
+		runs++;
+		elapsed	= ei_impl_stats_now() - start;
+	} while (elapsed < g_min_time || runs < 3);
+
+	printf("%s,%s,%d,%d,%llu,%.1f,%.2f\n", primitive, variant, b->size.width, b->size.height,
+	       (unsigned long long)calls, calls ? elapsed * 1e9 / calls : 0.0, pixels * runs / elapsed / 1e6);
+	fflush(stdout);
+}
+
+static void fill_pixels(ei_surface_t surface, ei_size_t size, uint8_t alpha)
+{
+	uint32_t*	pixels	= (uint32_t*)hw_surface_get_buffer(surface);
+	int		ir, ig, ib, ia;
+
+	hw_surface_get_channel_indices(surface, &ir, &ig, &ib, &ia);
+	for (int i = 0; i < size.width * size.height; i++)
+		pixels[i]	= (uint32_t)(0x40 + i % 0x80) << (8 * ir) | (uint32_t)0x90 << (8 * ig)
+				  | (uint32_t)(0xC0 - i % 0x40) << (8 * ib) | (ia < 0 ? 0 : (uint32_t)alpha << (8 * ia));
+}
+
+static void bench_size(ei_size_t size)
+{
+	bench_t		b		= { .size = size };
+	ei_rect_t	inset		= {{size.width / 8, size.height / 8}, {size.width * 3 / 4, size.height * 3 / 4}};
+	int		radius		= (size.width < size.height ? size.width : size.height) / 8;
+	int		h		= (inset.size.width < inset.size.height ? inset.size.width : inset.size.height) / 2;
+	int		width, nb_chars;
+
+	b.dst		= hw_surface_create(ei_app_root_surface(), size, false);
+	b.src		= hw_surface_create(ei_app_root_surface(), size, false);
+	b.src_alpha	= hw_surface_create(ei_app_root_surface(), size, true);
+	hw_surface_lock(b.dst);
+	hw_surface_lock(b.src);
+	hw_surface_lock(b.src_alpha);
+	fill_pixels(b.src, size, 0xff);
+	fill_pixels(b.src_alpha, size, 0x80);
+
+	// the same shapes as a button covering the middle of the surface (draw_frame in ei_implementation.c)
+	b.rect[0]	= inset.top_left;
+	b.rect[1]	= (ei_point_t){inset.top_left.x + inset.size.width, inset.top_left.y};
+	b.rect[2]	= (ei_point_t){inset.top_left.x + inset.size.width, inset.top_left.y + inset.size.height};
+	b.rect[3]	= (ei_point_t){inset.top_left.x, inset.top_left.y + inset.size.height};
+	give_rounded_frame(b.frame, inset, radius);
+	b.frame[40]	= b.frame[0];
+	give_lower_frame(b.frame, inset, h, b.relief);
+
+	hw_text_compute_size("M", ei_default_font, &width, &b.line_height);
+	nb_chars	= size.width / (width > 0 ? width : 1);
+	if (nb_chars >= (int)sizeof(b.line))
+		nb_chars	= sizeof(b.line) - 1;
+	for (int i = 0; i < nb_chars; i++)
+		b.line[i]	= (i % 6 == 5) ? ' ' : "Lorem ipsum dolor sit amet"[i % 26];
+	b.line[nb_chars] = '\0';
+
+	measure(&b, "fill", "opaque", fill_opaque);
+	measure(&b, "fill", "alpha", fill_alpha);
+	measure(&b, "fill", "clipped", fill_clipped);
+	measure(&b, "copy_surface", "opaque_aligned", copy_aligned);
+	measure(&b, "copy_surface", "opaque_unaligned", copy_unaligned);
+	measure(&b, "copy_surface", "alpha_aligned", copy_alpha_aligned);
+	measure(&b, "copy_surface", "alpha_unaligned", copy_alpha_unaligned);
+	measure(&b, "copy_surface", "alpha_clipped", copy_clipped);
+	measure(&b, "draw_polygon", "rect_4", polygon_rect);
+	measure(&b, "draw_polygon", "relief_23", polygon_relief);
+	measure(&b, "draw_polygon", "rounded_40", polygon_frame);
+	measure(&b, "draw_polygon", "rounded_40_alpha", polygon_frame_alpha);
+	measure(&b, "draw_polygon", "rounded_40_clipped", polygon_frame_clipped);
+	measure(&b, "draw_polyline", "rounded_41", polyline_frame);
+	if (b.line_height > 0)
+		measure(&b, "draw_text", "lines", text_lines);
+
+	hw_surface_unlock(b.dst);
+	hw_surface_unlock(b.src);
+	hw_surface_unlock(b.src_alpha);
+	hw_surface_free(b.dst);
+	hw_surface_free(b.src);
+	hw_surface_free(b.src_alpha);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && atof(argv[1]) > 0)
+		g_min_time	= atof(argv[1]);
+
+	ei_app_create((ei_size_t){64, 64}, false);
+
+	printf("primitive,variant,width,height,calls,ns_per_call,mpix_per_s\n");
+	for (size_t i = 0; i < sizeof(g_sizes) / sizeof(g_sizes[0]); i++)
+		bench_size(g_sizes[i]);
+
+	ei_app_free();
+	return (EXIT_SUCCESS);
+}
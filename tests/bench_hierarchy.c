@@ -0,0 +1,67 @@
+//
+//  bench_hierarchy.c
+//
+//  Measures the cost of the widget hierarchy operations when a single parent has many children:
+//  create (append at the end of the children), raise to the top (modify_hierarchy, as on a click)
+//  and destroy, for 1 000 to 100 000 siblings. With the doubly-linked sibling list, the time per
+//  operation should not grow with the number of siblings.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hw_interface.h"
+#include "ei_application.h"
+#include "ei_widget.h"
+#include "ei_implementation.h"
+#include "ei_implementation_toplevel.h"
+
+
+static const int		g_counts[]	= {1000, 10000, 100000};
+
+
+/*
+ * bench_siblings --
+ *
+ *	Creates "count" frames under the root widget, raises each of them to the top once
+ *	(starting with the bottom-most one), then destroys them in creation order.
+ *	Prints the average time of each operation, in nanoseconds.
+ */
+static void bench_siblings(int count)
+{
+	ei_widget_t	root		= ei_app_root_widget();
+	ei_widget_t*	widgets		= malloc(count * sizeof(ei_widget_t));
+	double		start;
+	double		create_time, raise_time, destroy_time;
+
+	start		= hw_now();
+	for (int i = 0; i < count; i++)
+		widgets[i]	= ei_widget_create("frame", root, NULL, NULL);
+	create_time	= hw_now() - start;
+
+	start		= hw_now();
+	for (int i = 0; i < count; i++)
+		modify_hierarchy(root->children_head, root);
+	raise_time	= hw_now() - start;
+
+	start		= hw_now();
+	for (int i = 0; i < count; i++)
+		ei_widget_destroy(widgets[i]);
+	destroy_time	= hw_now() - start;
+
+	printf("%7d siblings   create %8.1f ns   raise %8.1f ns   destroy %8.1f ns   (root empty: %s)\n",
+	       count, create_time * 1e9 / count, raise_time * 1e9 / count, destroy_time * 1e9 / count,
+	       root->children_head == NULL && root->children_tail == NULL ? "yes" : "no");
+	free(widgets);
+}
+
+int main(int argc, char** argv)
+{
+	ei_app_create((ei_size_t){800, 600}, false);
+
+	for (size_t i = 0; i < sizeof(g_counts) / sizeof(g_counts[0]); i++)
+		bench_siblings(g_counts[i]);
+
+	ei_app_free();
+	return (EXIT_SUCCESS);
+}
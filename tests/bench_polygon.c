@@ -0,0 +1,161 @@
+//
+//  bench_polygon.c
+//
+//  Compares the polygon rasterizer of libeibase (ei_draw_polygon) with the in-tree scanline
+//  rasterizer (ei_impl_raster_polygon) on the shapes that libei actually draws: rectangles,
+//  relief halves (23 points) and rounded frames (40 points), clipped and unclipped.
+//  Also counts the pixels on which both rasterizers disagree.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "hw_interface.h"
+#include "ei_draw.h"
+#include "ei_impl_raster.h"
+
+
+#define BENCH_ITERATIONS	2000
+
+static const ei_size_t		g_size		= {800, 600};
+
+
+/*
+ * rounded_frame --
+ *
+ *	Same 40 points as give_rounded_frame in implem/ei_outil_geom.c.
+ */
+static void rounded_frame(ei_point_t* points, ei_rect_t rect, int radius)
+{
+	float		pi	= 355./113.;
+	ei_point_t	center;
+
+	for (int i = 0; i < 40; i++) {
+		float xpos	= cosf(((float)i / 20) * pi);
+		float ypos	= sinf(((float)i / 20) * pi);
+		if (i < 10)
+			center	= (ei_point_t){rect.top_left.x + rect.size.width - radius, rect.top_left.y + radius};
+		else if (i < 20)
+			center	= (ei_point_t){rect.top_left.x + radius, rect.top_left.y + radius};
+		else if (i < 30)
+			center	= (ei_point_t){rect.top_left.x + radius, rect.top_left.y + rect.size.height - radius};
+		else
+			center	= (ei_point_t){rect.top_left.x + rect.size.width - radius, rect.top_left.y + rect.size.height - radius};
+		points[i]	= (ei_point_t){center.x + (xpos * radius), center.y - (ypos * radius)};
+	}
+}
+
+typedef void (*polygon_func_t)(ei_surface_t, ei_point_t*, size_t, ei_color_t, const ei_rect_t*);
+
+static void in_tree_polygon(ei_surface_t surface, ei_point_t* points, size_t size, ei_color_t color, const ei_rect_t* clipper)
+{
+	ei_impl_raster_polygon(surface, points, size, color, clipper);
+}
+
+/*
+ * time_polygon --
+ *
+ *	Returns the average time, in microseconds, of one call to "draw".
+ */
+static double time_polygon(polygon_func_t draw, ei_surface_t surface, ei_point_t* points, size_t size,
+			   ei_color_t color, const ei_rect_t* clipper)
+{
+	double		start;
+
+	draw(surface, points, size, color, clipper);
+	start		= hw_now();
+	for (int i = 0; i < BENCH_ITERATIONS; i++)
+		draw(surface, points, size, color, clipper);
+	return (hw_now() - start) * 1e6 / BENCH_ITERATIONS;
+}
+
+/*
+ * count_differences --
+ *
+ *	Draws the same polygon on two cleared surfaces, one per rasterizer, and counts the pixels
+ *	that differ.
+ */
+static int count_differences(ei_surface_t lib_surface, ei_surface_t tree_surface, ei_point_t* points, size_t size,
+			     ei_color_t color, const ei_rect_t* clipper)
+{
+	uint32_t*	lib_pixels;
+	uint32_t*	tree_pixels;
+	int		differences	= 0;
+
+	lib_pixels	= (uint32_t*)hw_surface_get_buffer(lib_surface);
+	tree_pixels	= (uint32_t*)hw_surface_get_buffer(tree_surface);
+	memset(lib_pixels, 0, g_size.width * g_size.height * sizeof(uint32_t));
+	memset(tree_pixels, 0, g_size.width * g_size.height * sizeof(uint32_t));
+	ei_draw_polygon(lib_surface, points, size, color, clipper);
+	in_tree_polygon(tree_surface, points, size, color, clipper);
+
+	for (int i = 0; i < g_size.width * g_size.height; i++)
+		if (lib_pixels[i] != tree_pixels[i])
+			differences++;
+	return differences;
+}
+
+static void bench_shape(const char* label, ei_surface_t lib_surface, ei_surface_t tree_surface,
+			ei_point_t* points, size_t size, ei_color_t color, const ei_rect_t* clipper)
+{
+	double		lib_time	= time_polygon(ei_draw_polygon, lib_surface, points, size, color, clipper);
+	double		tree_time	= time_polygon(in_tree_polygon, tree_surface, points, size, color, clipper);
+	int		differences	= count_differences(lib_surface, tree_surface, points, size, color, clipper);
+
+	printf("%-28s %3zu pts  libeibase %9.2f us  in-tree %9.2f us  speedup x%5.2f  diff %d px\n",
+	       label, size, lib_time, tree_time, lib_time / tree_time, differences);
+}
+
+int main(int argc, char** argv)
+{
+	ei_surface_t	root;
+	ei_surface_t	lib_surface;
+	ei_surface_t	tree_surface;
+	ei_rect_t	button		= {{100, 100}, {300, 120}};
+	ei_rect_t	clipper		= {{150, 80}, {200, 100}};
+	ei_rect_t	full		= {{0, 0}, g_size};
+	ei_color_t	opaque		= {0x88, 0x99, 0xaa, 0xff};
+	ei_color_t	translucent	= {0x88, 0x99, 0xaa, 0x80};
+	ei_point_t	rect[4];
+	ei_point_t	frame[40];
+	ei_point_t	relief[23];
+	ei_point_t	window[40];
+
+	hw_init();
+	root		= hw_create_window(g_size, false);
+	lib_surface	= hw_surface_create(root, g_size, false);
+	tree_surface	= hw_surface_create(root, g_size, false);
+	hw_surface_lock(lib_surface);
+	hw_surface_lock(tree_surface);
+
+	rect[0]		= button.top_left;
+	rect[1]		= (ei_point_t){button.top_left.x + button.size.width, button.top_left.y};
+	rect[2]		= (ei_point_t){button.top_left.x + button.size.width, button.top_left.y + button.size.height};
+	rect[3]		= (ei_point_t){button.top_left.x, button.top_left.y + button.size.height};
+
+	rounded_frame(frame, button, 20);
+	for (int i = 0; i < 21; i++)
+		relief[i]	= frame[5 + i];
+	relief[21]	= (ei_point_t){button.top_left.x + 60, button.top_left.y + 60};
+	relief[22]	= (ei_point_t){button.top_left.x + button.size.width - 60, button.top_left.y + 60};
+
+	rounded_frame(window, full, 30);
+
+	bench_shape("rectangle", lib_surface, tree_surface, rect, 4, opaque, NULL);
+	bench_shape("rectangle clipped", lib_surface, tree_surface, rect, 4, opaque, &clipper);
+	bench_shape("relief half", lib_surface, tree_surface, relief, 23, opaque, NULL);
+	bench_shape("relief half translucent", lib_surface, tree_surface, relief, 23, translucent, NULL);
+	bench_shape("rounded frame", lib_surface, tree_surface, frame, 40, opaque, NULL);
+	bench_shape("rounded frame clipped", lib_surface, tree_surface, frame, 40, opaque, &clipper);
+	bench_shape("full window frame", lib_surface, tree_surface, window, 40, opaque, NULL);
+
+	hw_surface_unlock(lib_surface);
+	hw_surface_unlock(tree_surface);
+	hw_surface_free(lib_surface);
+	hw_surface_free(tree_surface);
+	hw_quit();
+
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,287 @@
+//
+//  bench_scenes.c
+//
+//  Generated scenes that stress the widget tree, the layout and the damage code:
+//	buttons		10 000 flat buttons, side by side
+//	toplevels	1 000 toplevels, in 10 chains of 100 nested ones, each with a frame inside
+//	text_grid	100 x 100 frames with text
+//	images		200 overlapping buttons with an image
+//  For each scene: the time to create and place the widgets, to lay out and draw the whole screen,
+//  to invalidate and redraw a single widget, to pick a widget under a point, and to destroy the
+//  scene. Frames are produced by ei_impl_app_render, as in the main loop.
+//
+//  One CSV line per scene on the standard output:
+//	scene,widgets,create_ms,first_draw_ms,redraw_us,pick_ns,destroy_ms
+//
+//  There is one target per scene, bench_scene_<name>: BENCH_SCENE names the scene to run
+//  (all the scenes when it is not defined).
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "hw_interface.h"
+#include "ei_application.h"
+#include "ei_widget.h"
+#include "ei_widget_configure.h"
+#include "ei_placer.h"
+#include "ei_implementation.h"
+#include "ei_impl_stats.h"
+
+
+#define BENCH_PICKS		20000
+#define BENCH_REDRAW_TIME	0.2
+
+static const ei_size_t		g_root_size	= {1920, 1080};
+
+
+/*
+ * A scene creates its widgets under the root and returns them: "roots" are the children of the
+ * root (destroyed one by one at the end), "target" is the widget redrawn alone.
+ */
+typedef struct {
+	ei_widget_t*	widgets;
+	int		nb_widgets;
+	ei_widget_t*	roots;
+	int		nb_roots;
+	ei_widget_t	target;
+	ei_font_t	font;
+	ei_surface_t	image;
+} scene_t;
+
+typedef void (*scene_func_t)(scene_t* scene);
+
+
+static ei_color_t color_of(int i)
+{
+	return (ei_color_t){(uint8_t)(0x40 + i * 37 % 0xa0), (uint8_t)(0x40 + i * 59 % 0xa0), (uint8_t)(0x40 + i * 83 % 0xa0), 0xff};
+}
+
+static void scene_alloc(scene_t* scene, int nb_widgets)
+{
+	scene->widgets		= malloc(nb_widgets * sizeof(ei_widget_t));
+	scene->nb_widgets	= 0;
+}
+
+static ei_widget_t scene_add(scene_t* scene, ei_widget_t widget)
+{
+	scene->widgets[scene->nb_widgets++]	= widget;
+	return widget;
+}
+
+
+/*
+ * buttons --
+ *
+ *	100 x 100 flat buttons of 19 x 10 pixels.
+ */
+static void scene_buttons(scene_t* scene)
+{
+	ei_size_t	size		= {19, 10};
+	int		border		= 0;
+	int		radius		= 0;
+	ei_relief_t	relief		= ei_relief_none;
+
+	scene_alloc(scene, 100 * 100);
+	for (int i = 0; i < 100 * 100; i++) {
+		ei_widget_t	button	= scene_add(scene, ei_widget_create("button", ei_app_root_widget(), NULL, NULL));
+		ei_color_t	color	= color_of(i);
+
+		ei_button_configure(button, &size, &color, &border, &radius, &relief, NULL, NULL, NULL, NULL,
+				    NULL, NULL, NULL, NULL, NULL);
+		ei_place_xy(button, (i % 100) * size.width, 40 + (i / 100) * size.height);
+	}
+	scene->roots	= scene->widgets;
+	scene->nb_roots	= scene->nb_widgets;
+	scene->target	= scene->widgets[50 * 100 + 50];
+}
+
+/*
+ * toplevels --
+ *
+ *	10 chains of 100 toplevels, each one inside the previous one, with a frame beside it.
+ */
+static void scene_toplevels(scene_t* scene)
+{
+	ei_string_t	title		= "Nested";
+	int		border		= 1;
+	ei_size_t	frame_size	= {24, 16};
+
+	scene_alloc(scene, 10 * 100 * 2);
+	scene->roots	= malloc(10 * sizeof(ei_widget_t));
+	scene->nb_roots	= 10;
+	for (int chain = 0; chain < 10; chain++) {
+		ei_widget_t	parent	= ei_app_root_widget();
+
+		for (int depth = 0; depth < 100; depth++) {
+			ei_widget_t	toplevel	= scene_add(scene, ei_widget_create("toplevel", parent, NULL, NULL));
+			ei_widget_t	frame		= scene_add(scene, ei_widget_create("frame", toplevel, NULL, NULL));
+			ei_size_t	size		= {190 - depth, 1000 - 4 * depth};
+			ei_color_t	color		= color_of(chain * 100 + depth);
+
+			ei_toplevel_configure(toplevel, &size, &color, &border, &title, NULL, NULL, NULL);
+			if (depth == 0) {
+				scene->roots[chain]	= toplevel;
+				ei_place_xy(toplevel, chain * 190, 40);
+			} else
+				ei_place_xy(toplevel, 2, 24);
+			ei_frame_configure(frame, &frame_size, &color, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+			ei_place_xy(frame, 2, 2);
+			parent		= toplevel;
+		}
+	}
+	scene->target	= scene->widgets[5 * 200 + 2 * 10];
+}
+
+/*
+ * text_grid --
+ *
+ *	100 x 100 frames of 19 x 10 pixels, each with its number as text.
+ */
+static void scene_text_grid(scene_t* scene)
+{
+	ei_size_t	size		= {19, 10};
+	ei_color_t	text_color	= {0x00, 0x00, 0x00, 0xff};
+	char		text[8];
+	ei_string_t	string		= text;
+
+	scene->font	= hw_text_font_create(ei_default_font_filename, ei_style_normal, 8);
+	scene_alloc(scene, 100 * 100);
+	for (int i = 0; i < 100 * 100; i++) {
+		ei_widget_t	frame	= scene_add(scene, ei_widget_create("frame", ei_app_root_widget(), NULL, NULL));
+		ei_color_t	color	= color_of(i);
+
+		snprintf(text, sizeof(text), "%d", i);
+		ei_frame_configure(frame, &size, &color, NULL, NULL, &string, &scene->font, &text_color, NULL,
+				   NULL, NULL, NULL);
+		ei_place_xy(frame, (i % 100) * size.width, 40 + (i / 100) * size.height);
+	}
+	scene->roots	= scene->widgets;
+	scene->nb_roots	= scene->nb_widgets;
+	scene->target	= scene->widgets[50 * 100 + 50];
+}
+
+/*
+ * images --
+ *
+ *	200 buttons of 240 x 180 pixels showing parts of an image, each one overlapping a dozen others.
+ */
+static void scene_images(scene_t* scene)
+{
+	ei_size_t	size		= {240, 180};
+	ei_rect_t	rects[200];
+
+	scene->image	= hw_image_load("misc/klimt.jpg", ei_app_root_surface());
+	if (scene->image == NULL) {
+		// without the image file, a generated one of the same kind (with an alpha channel)
+		scene->image	= hw_surface_create(ei_app_root_surface(), (ei_size_t){512, 512}, true);
+		ei_fill(scene->image, &(ei_color_t){0x80, 0x60, 0x40, 0xff}, NULL);
+	}
+	scene_alloc(scene, 200);
+	for (int i = 0; i < 200; i++) {
+		ei_widget_t	button	= scene_add(scene, ei_widget_create("button", ei_app_root_widget(), NULL, NULL));
+		ei_color_t	color	= color_of(i);
+		ei_rect_ptr_t	rect	= &rects[i];
+
+		rects[i]	= (ei_rect_t){{i * 13 % 16, i * 7 % 16}, size};
+		ei_button_configure(button, &size, &color, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+				    &scene->image, &rect, NULL, NULL, NULL);
+		ei_place_xy(button, (i % 20) * 84, 40 + (i / 20) * 84);
+	}
+	scene->roots	= scene->widgets;
+	scene->nb_roots	= scene->nb_widgets;
+	scene->target	= scene->widgets[105];
+}
+
+
+static const struct {
+	const char*	name;
+	scene_func_t	create;
+} g_scenes[] = {
+	{ "buttons",	scene_buttons },
+	{ "toplevels",	scene_toplevels },
+	{ "text_grid",	scene_text_grid },
+	{ "images",	scene_images },
+};
+
+
+static void bench_scene(const char* name, scene_func_t create)
+{
+	scene_t		scene		= { 0 };
+	ei_widget_t	root		= ei_app_root_widget();
+	ei_rect_t	screen		= root->screen_location;
+	double		start, create_time, draw_time, redraw_time, pick_time, destroy_time;
+	int		redraws		= 0;
+	uint32_t	seed		= 12345;
+	int		hits		= 0;
+
+	start		= ei_impl_stats_now();
+	create(&scene);
+	create_time	= ei_impl_stats_now() - start;
+
+	// the first frame lays out and draws everything
+	start		= ei_impl_stats_now();
+	ei_app_invalidate_rect(&screen);
+	ei_impl_app_render();
+	draw_time	= ei_impl_stats_now() - start;
+
+	start		= ei_impl_stats_now();
+	do {
+		ei_app_invalidate_rect(&scene.target->screen_location);
+		ei_impl_app_render();
+		redraws++;
+		redraw_time	= ei_impl_stats_now() - start;
+	} while (redraw_time < BENCH_REDRAW_TIME || redraws < 10);
+
+	ei_widget_pick(&(ei_point_t){0, 0});
+	start		= ei_impl_stats_now();
+	for (int i = 0; i < BENCH_PICKS; i++) {
+		ei_point_t	where;
+
+		seed		= seed * 1664525 + 1013904223;
+		where.x		= (int)((seed >> 8) % (uint32_t)screen.size.width);
+		seed		= seed * 1664525 + 1013904223;
+		where.y		= (int)((seed >> 8) % (uint32_t)screen.size.height);
+		if (ei_widget_pick(&where) != NULL)
+			hits++;
+	}
+	pick_time	= ei_impl_stats_now() - start;
+
+	start		= ei_impl_stats_now();
+	for (int i = 0; i < scene.nb_roots; i++)
+		ei_widget_destroy(scene.roots[i]);
+	destroy_time	= ei_impl_stats_now() - start;
+	ei_impl_app_render();
+
+	printf("%s,%d,%.3f,%.3f,%.2f,%.1f,%.3f\n", name, scene.nb_widgets, create_time * 1e3, draw_time * 1e3,
+	       redraw_time * 1e6 / redraws, pick_time * 1e9 / BENCH_PICKS, destroy_time * 1e3);
+	fflush(stdout);
+
+	if (hits == 0)
+		fprintf(stderr, "bench_scenes: no widget picked in scene %s\n", name);
+	if (scene.font)
+		hw_text_font_free(scene.font);
+	if (scene.image)
+		hw_surface_free(scene.image);
+	if (scene.roots != scene.widgets)
+		free(scene.roots);
+	free(scene.widgets);
+}
+
+int main(int argc, char** argv)
+{
+	ei_app_create(g_root_size, false);
+
+	printf("scene,widgets,create_ms,first_draw_ms,redraw_us,pick_ns,destroy_ms\n");
+	for (size_t i = 0; i < sizeof(g_scenes) / sizeof(g_scenes[0]); i++) {
+#ifdef BENCH_SCENE
+		if (strcmp(g_scenes[i].name, BENCH_SCENE) != 0)
+			continue;
+#endif
+		bench_scene(g_scenes[i].name, g_scenes[i].create);
+	}
+
+	ei_app_free();
+	return (EXIT_SUCCESS);
+}
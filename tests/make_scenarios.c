@@ -0,0 +1,200 @@
+//
+//  make_scenarios.c
+//
+//  Writes the event logs replayed by the perf_puzzle, perf_two048 and perf_minesweeper targets
+//  (tests/scenarios/*.eirec, see ei_impl_record.h). The interactions are scripted rather than
+//  recorded by hand, so that the scenarios can be regenerated when the test applications change:
+//  toplevels dragged at the rate of a 125 Hz mouse, clicks on tiles and cells, and arrow keys.
+//
+//  Usage: make_scenarios [directory]	(defaults to tests/scenarios)
+//
+
+#include <stdio.h>
+#include <math.h>
+
+#include "ei_event.h"
+#include "ei_utils.h"
+#include "ei_impl_record.h"
+
+
+static FILE*		g_out		= NULL;
+static int		g_delay		= 0;	// milliseconds since the previous event
+
+
+/*
+ * wait --
+ *
+ *	Adds a delay before the next event.
+ */
+static void wait(int ms)
+{
+	g_delay		+= ms;
+}
+
+static void emit(ei_event_t* event)
+{
+	ei_impl_record_write(g_out, event, g_delay / 1000.0);
+	g_delay		= 0;
+}
+
+static void mouse(ei_eventtype_t type, int x, int y, ei_mouse_button_t button)
+{
+	ei_event_t	event		= { .type = type };
+
+	event.param.mouse.where		= ei_point(x, y);
+	event.param.mouse.button	= button;
+	emit(&event);
+}
+
+static void key(SDL_Keycode code, ei_modifier_mask_t modifiers)
+{
+	ei_event_t	event		= { .type = ei_ev_keydown, .modifier_mask = modifiers };
+
+	event.param.key_code	= code;
+	emit(&event);
+	wait(40);
+	event.type		= ei_ev_keyup;
+	emit(&event);
+}
+
+static void click(int x, int y, ei_mouse_button_t button)
+{
+	mouse(ei_ev_mouse_move, x, y, button);
+	wait(30);
+	mouse(ei_ev_mouse_buttondown, x, y, button);
+	wait(60);
+	mouse(ei_ev_mouse_buttonup, x, y, button);
+}
+
+/*
+ * drag --
+ *
+ *	Drags with the left button from (x0, y0) to (x1, y1), one move every 8 ms.
+ *	With "loops" > 0, the pointer also turns that many times around a circle of radius 120
+ *	on the way, so that the dragged window crosses the rest of the screen.
+ */
+static void drag(int x0, int y0, int x1, int y1, int steps, int loops)
+{
+	mouse(ei_ev_mouse_move, x0, y0, ei_mouse_button_left);
+	wait(30);
+	mouse(ei_ev_mouse_buttondown, x0, y0, ei_mouse_button_left);
+	for (int i = 1; i <= steps; i++) {
+		double	t	= (double)i / steps;
+		double	angle	= 2 * M_PI * loops * t;
+		int	x	= (int)lround(x0 + (x1 - x0) * t + 120 * sin(angle));
+		int	y	= (int)lround(y0 + (y1 - y0) * t + 120 * (1 - cos(angle)));
+
+		wait(8);
+		mouse(ei_ev_mouse_move, x, y, ei_mouse_button_left);
+	}
+	wait(30);
+	mouse(ei_ev_mouse_buttonup, x1, y1, ei_mouse_button_left);
+}
+
+static bool begin(const char* dir, const char* name, ei_size_t root_size)
+{
+	char	path[1024];
+
+	snprintf(path, sizeof(path), "%s/%s.eirec", dir, name);
+	if ((g_out = ei_impl_record_open(path, root_size)) == NULL) {
+		fprintf(stderr, "make_scenarios: cannot write %s\n", path);
+		return false;
+	}
+	g_delay		= 500;
+	printf("%s\n", path);
+	return true;
+}
+
+
+/*
+ * puzzle --
+ *
+ *	Clicks on the tiles of the puzzle, drags its window around the screen, then clicks on
+ *	the tiles again at the new position of the window.
+ */
+static void puzzle(void)
+{
+	for (int i = 0; i < 40; i++) {
+		click(100 + 128 * (i % 2), 100 + 128 * ((i / 2) % 2), ei_mouse_button_left);
+		wait(120);
+	}
+	drag(100, 18, 600, 300, 400, 2);
+	wait(200);
+	for (int i = 0; i < 40; i++) {
+		click(600 + 128 * (i % 2), 380 + 128 * ((i / 2) % 2), ei_mouse_button_left);
+		wait(120);
+	}
+	drag(600, 300, 100, 18, 250, 1);
+	wait(500);
+}
+
+/*
+ * two048 --
+ *
+ *	Plays a few hundred moves, drags the game window around the screen, then plays again.
+ *	Letter keys are avoided: the entry class handles every key press (ei_callback_entry).
+ */
+static void two048(void)
+{
+	static const SDL_Keycode	k_moves[]	= { SDLK_UP, SDLK_LEFT, SDLK_DOWN, SDLK_RIGHT,
+							    SDLK_LEFT, SDLK_UP, SDLK_RIGHT, SDLK_DOWN };
+
+	for (int i = 0; i < 240; i++) {
+		key(k_moves[i % 8], 0);
+		wait(80);
+	}
+	drag(100, 30, 400, 200, 300, 2);
+	wait(200);
+	for (int i = 0; i < 240; i++) {
+		key(k_moves[(i * 3) % 8], 0);
+		wait(80);
+	}
+	wait(500);
+}
+
+/*
+ * minesweeper --
+ *
+ *	Flags and reveals cells of the 22x16 board, then drags the game window around the
+ *	screen and back.
+ */
+static void minesweeper(void)
+{
+	int	x0		= 62;		// center of the top-left cell
+	int	y0		= 128;
+
+	for (int i = 0; i < 60; i++) {
+		int	cx	= (i * 7) % 22;
+		int	cy	= (i * 5) % 16;
+
+		click(x0 + 28 * cx, y0 + 28 * cy, (i % 3 == 0) ? ei_mouse_button_left : ei_mouse_button_right);
+		wait(150);
+	}
+	drag(200, 50, 480, 200, 500, 2);
+	wait(200);
+	drag(480, 200, 200, 50, 300, 1);
+	wait(500);
+}
+
+
+int main(int argc, char* argv[])
+{
+	const char*	dir	= (argc > 1) ? argv[1] : "tests/scenarios";
+
+	if (!begin(dir, "puzzle", ei_size(1024, 768)))
+		return 1;
+	puzzle();
+	fclose(g_out);
+
+	if (!begin(dir, "two048", ei_size(1024, 768)))
+		return 1;
+	two048();
+	fclose(g_out);
+
+	if (!begin(dir, "minesweeper", ei_size(1200, 800)))
+		return 1;
+	minesweeper();
+	fclose(g_out);
+
+	return 0;
+}
@@ -18,6 +18,7 @@
 #include "ei_utils.h"
 #include "ei_event.h"
 #include "ei_placer.h"
+#include "ei_timer.h"
 
 /* constants */
 
@@ -307,16 +308,16 @@ bool default_handler(ei_widget_t widget, ei_event_t* event, ei_user_param_t user
 		ei_app_quit_request();
 		return true;
 
-	} else if ((event->type == ei_ev_app) && (event->param.application.user_param == &g_game_window)) {
-		if (g_game_window != NULL)
-			handle_time((map_t*)ei_widget_get_user_data(g_game_window));
-		hw_event_schedule_app(250, &g_game_window);
-		return true;
-
 	} else
 		return false;
 }
 
+void clock_tick(ei_timer_t timer, ei_user_param_t user_param)
+{
+	if (g_game_window != NULL)
+		handle_time((map_t*)ei_widget_get_user_data(g_game_window));
+}
+
 ei_widget_t create_game_window(ei_size_t map_size, int nb_mine);
 
 bool restart_button_cb(ei_widget_t widget, ei_event_t* event, ei_user_param_t user_param)
@@ -549,15 +550,14 @@ int main(int argc, char* argv[])
 
 	ei_bind(ei_ev_keydown, NULL, "all", default_handler, NULL);
 	ei_bind(ei_ev_close, NULL, "all", default_handler, NULL);
-	ei_bind(ei_ev_app, NULL, "all", default_handler, NULL);		// for timer events
-
-	hw_event_schedule_app(250, &g_game_window);
+	ei_timer_t clock = ei_timer_repeat(250, clock_tick, NULL);
 
 	ei_app_run();
 
+	ei_timer_cancel(clock);
+
 	ei_unbind(ei_ev_keydown, NULL, "all", default_handler, NULL);
 	ei_unbind(ei_ev_close, NULL, "all", default_handler, NULL);
-	ei_unbind(ei_ev_app, NULL, "all", default_handler, NULL);
 
 	hw_surface_free(g_flag_img);
 	hw_surface_free(g_bomb_img);
@@ -17,6 +17,7 @@
 #include "ei_utils.h"
 #include "ei_event.h"
 #include "ei_placer.h"
+#include "ei_grid.h"
 
 
 static const int		k_tile_size			= 128;
@@ -42,11 +43,6 @@ typedef struct puzzle_t {
 
 } puzzle_t;
 
-static inline ei_point_t place_coordinates(ei_point_t pos)
-{
-	return ei_point(pos.x*k_tile_size, pos.y*k_tile_size);
-}
-
 static inline bool valid(puzzle_t* puzzle, ei_point_t position)
 {
 	return 	(position.x >= 0) &&
@@ -77,7 +73,6 @@ void randomize(puzzle_t* puzzle)
 	int 		n_positions	= n_tiles;
 	int*		positions	= (int*)malloc((size_t)n_positions * sizeof(int));
 	tile_t*		tile;
-	ei_point_t	new_coords;
 
 	srand((unsigned)time(NULL)); // random seed
 
@@ -89,8 +84,7 @@ void randomize(puzzle_t* puzzle)
 		position		= rand() % n_positions;
 
 		tile->current_position	= ei_point(positions[position] % puzzle->n.width, positions[position] / puzzle->n.height);
-		new_coords		= place_coordinates(tile->current_position);
-		ei_place_xy(tile->button, new_coords.x, new_coords.y);
+		ei_grid_cell(tile->button, tile->current_position.y, tile->current_position.x);
 
 		for (p = position + 1; p < n_positions; p++)
 			positions[p-1]	= positions[p];
@@ -107,7 +101,6 @@ bool handle_tile_press(ei_widget_t widget, ei_event_t* event, ei_user_param_t us
 	ei_point_t	offsets[]	= {{0, -1}, {-1, 0}, {1, 0}, {0, 1}};
 	ei_point_t	current		= tile->current_position;
 	ei_point_t	swap_pos;
-	ei_point_t	swap_coordinates;
 	int		i;
 	
 	for (i = 0; i < 4; i++) {
@@ -116,8 +109,7 @@ bool handle_tile_press(ei_widget_t widget, ei_event_t* event, ei_user_param_t us
 			puzzle->current[index_at(puzzle, current)]	= NULL;
 			puzzle->current[index_at(puzzle, swap_pos)]	= tile;
 			tile->current_position				= swap_pos;
-			swap_coordinates				= place_coordinates(swap_pos);
-			ei_place_xy(tile->button, swap_coordinates.x, swap_coordinates.y);
+			ei_grid_cell(tile->button, swap_pos.y, swap_pos.x);
 		}
 	}
 
@@ -135,7 +127,7 @@ void create_puzzle_window(ei_string_t image_filename)
 	ei_size_t		image_size;
 	int			x, y;
 	int			border_width		= 2;
-	ei_point_t		place_coords;
+	bool			uniform			= true;
 	ei_point_t		current_position;
 	ei_size_t		n;
 	ei_size_t		toplevel_size;
@@ -167,6 +159,10 @@ void create_puzzle_window(ei_string_t image_filename)
 	ei_place_xy(toplevel, g_toplevel_position.x, g_toplevel_position.y);
 	g_toplevel_position = ei_point_add(g_toplevel_position, ei_point(12, 12));
 
+	// The tiles are laid out by the grid: all the rows and columns have the size of a tile,
+	// including the row and column of the empty cell.
+	ei_grid_uniform(toplevel, &uniform, &uniform);
+
 	puzzle->n	= n;
 	puzzle->tiles	= (tile_t*) malloc((size_t)(n.width*n.height)*sizeof(tile_t));
 	puzzle->current	= (tile_t**)malloc((size_t)(n.width*n.height)*sizeof(tile_t*));
@@ -187,8 +183,7 @@ void create_puzzle_window(ei_string_t image_filename)
 			tile			= tile_memory_at(puzzle, ei_point(x, y));
 			ei_button_configure(button, &tile_size, &grey, &border_width, &corner_radius, &relief, NULL, NULL, NULL,
 								NULL, &image, &img_rect_ptr, NULL, &callback, (void*)&tile);
-			place_coords		= place_coordinates(current_position);
-			ei_place_xy(button, place_coords.x, place_coords.y);
+			ei_grid_cell(button, y, x);
 
 			tile->puzzle		= puzzle;
 			tile->button		= button;